@@ -0,0 +1,156 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "attendeetablemodeltest.h"
+#include "attendeetablemodel.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(AttendeeTableModelTest)
+
+using namespace IncidenceEditorNG;
+
+static KCalendarCore::Attendee attendee(const QString &name, const QString &email, const QString &uid = QString())
+{
+    return KCalendarCore::Attendee(name, email, false, KCalendarCore::Attendee::NeedsAction, KCalendarCore::Attendee::ReqParticipant, uid);
+}
+
+void AttendeeTableModelTest::testEmailIndex()
+{
+    AttendeeTableModel model;
+    const KCalendarCore::Attendee fred = attendee(QStringLiteral("Fred"), QStringLiteral("fred@example.com"));
+    const KCalendarCore::Attendee joe = attendee(QStringLiteral("Joe"), QStringLiteral("joe@example.com"));
+    const KCalendarCore::Attendee otherFred = attendee(QStringLiteral("Fred Two"), QStringLiteral("Fred@Example.com"));
+    model.setAttendees({fred, joe, otherFred});
+
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("FRED@example.com ")), QVector<int>({0, 2}));
+    QCOMPARE(model.rowOfAttendee(otherFred), 2);
+    QCOMPARE(model.rowOfAttendee(joe), 1);
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("jane@example.com")), QVector<int>());
+
+    // inserting shifts the rows behind
+    const KCalendarCore::Attendee jane = attendee(QStringLiteral("Jane"), QStringLiteral("jane@example.com"));
+    model.insertAttendee(1, jane);
+    QCOMPARE(model.rowOfAttendee(jane), 1);
+    QCOMPARE(model.rowOfAttendee(joe), 2);
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("fred@example.com")), QVector<int>({0, 3}));
+
+    // so does removing
+    model.removeRows(0, 1);
+    QCOMPARE(model.rowOfAttendee(fred), -1);
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("fred@example.com")), QVector<int>({2}));
+    QCOMPARE(model.rowOfAttendee(jane), 0);
+
+    // changing the email moves the row in the index
+    QVERIFY(model.setData(model.index(0, AttendeeTableModel::FullName), QStringLiteral("Jane <fred@example.com>")));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("jane@example.com")), QVector<int>());
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("fred@example.com")), QVector<int>({0, 2}));
+
+    const KCalendarCore::Attendee::List attendees = model.attendees();
+    for (int row = 0; row < attendees.size(); ++row) {
+        QCOMPARE(model.rowOfAttendee(attendees.at(row)), row);
+    }
+}
+
+void AttendeeTableModelTest::testUidIndex()
+{
+    AttendeeTableModel model;
+    model.setAttendees({attendee(QStringLiteral("Fred"), QStringLiteral("fred@example.com"), QStringLiteral("uid-fred")),
+                        attendee(QStringLiteral("Joe"), QStringLiteral("joe@example.com"), QStringLiteral("uid-joe"))});
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-joe")), 1);
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-fred")), 0);
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-jane")), -1);
+
+    model.insertAttendee(0, attendee(QStringLiteral("Jane"), QStringLiteral("jane@example.com"), QStringLiteral("uid-jane")));
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-jane")), 0);
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-joe")), 2);
+
+    model.removeRows(0, 2);
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-fred")), -1);
+    QCOMPARE(model.rowOfUid(QStringLiteral("uid-joe")), 0);
+}
+
+void AttendeeTableModelTest::testUidIndexAfterEdit()
+{
+    AttendeeTableModel model;
+    model.setAttendees({attendee(QStringLiteral("Fred"), QStringLiteral("fred@example.com")),
+                        attendee(QStringLiteral("Joe"), QStringLiteral("joe@example.com"))});
+
+    // Without a uid, it is made up and changes when the attendee is detached,
+    // which keeping a copy of the list forces here.
+    const KCalendarCore::Attendee::List before = model.attendees();
+    const QString oldUid = before.at(0).uid();
+    QCOMPARE(model.rowOfUid(oldUid), 0);
+    QCOMPARE(model.rowOfUid(before.at(1).uid()), 1);
+
+    QVERIFY(model.setData(model.index(0, AttendeeTableModel::Role), KCalendarCore::Attendee::OptParticipant));
+    const QString newUid = model.attendees().at(0).uid();
+    QVERIFY(newUid != oldUid);
+    QCOMPARE(model.rowOfUid(oldUid), -1);
+    QCOMPARE(model.rowOfUid(newUid), 0);
+    QCOMPARE(model.rowOfUid(before.at(1).uid()), 1);
+}
+
+void AttendeeTableModelTest::testInsertAttendees()
+{
+    AttendeeTableModel model;
+    model.setAttendees({attendee(QStringLiteral("Fred"), QStringLiteral("fred@example.com")),
+                        attendee(QStringLiteral("Joe"), QStringLiteral("joe@example.com"))});
+
+    KCalendarCore::Attendee::List members;
+    for (int i = 0; i < 100; ++i) {
+        members.append(attendee(QStringLiteral("Member %1").arg(i), QStringLiteral("member%1@example.com").arg(i)));
+    }
+
+    QSignalSpy spy(&model, &AttendeeTableModel::rowsInserted);
+    QVERIFY(model.insertAttendees(1, members));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(1).toInt(), 1);
+    QCOMPARE(spy.at(0).at(2).toInt(), 100);
+
+    QCOMPARE(model.rowCount(), 102);
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("fred@example.com")), QVector<int>({0}));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("joe@example.com")), QVector<int>({101}));
+    for (int i = 0; i < members.size(); ++i) {
+        QCOMPARE(model.rowOfAttendee(members.at(i)), i + 1);
+    }
+
+    QVERIFY(!model.insertAttendees(0, {}));
+    QCOMPARE(spy.count(), 1);
+}
+
+void AttendeeTableModelTest::testIndexesAfterRowChanges()
+{
+    AttendeeTableModel model;
+    KCalendarCore::Attendee::List attendees;
+    for (int i = 0; i < 10; ++i) {
+        attendees.append(attendee(QStringLiteral("Member %1").arg(i), QStringLiteral("member%1@example.com").arg(i), QStringLiteral("uid-%1").arg(i)));
+    }
+    model.setAttendees(attendees);
+
+    // removing from the top shifts the rows of all others
+    QVERIFY(model.removeRows(0, 2));
+    QVERIFY(model.removeRows(0, 1));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("member3@example.com")), QVector<int>({0}));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("member0@example.com")), QVector<int>());
+    QCOMPARE(model.rowOfUid(attendees.at(9).uid()), 6);
+
+    // appending and removing the last rows keeps the other rows
+    const KCalendarCore::Attendee joe = attendee(QStringLiteral("Joe"), QStringLiteral("member3@example.com"));
+    QVERIFY(model.insertAttendee(model.rowCount(), joe));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("member3@example.com")), QVector<int>({0, 7}));
+    QCOMPARE(model.rowOfAttendee(joe), 7);
+    QVERIFY(model.removeRows(6, 2));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("member3@example.com")), QVector<int>({0}));
+    QCOMPARE(model.rowOfUid(attendees.at(9).uid()), -1);
+    QCOMPARE(model.rowOfUid(attendees.at(8).uid()), 5);
+
+    // inserting in between
+    QVERIFY(model.insertAttendee(1, joe));
+    QCOMPARE(model.rowsOfEmail(QStringLiteral("member3@example.com")), QVector<int>({0, 1}));
+    QCOMPARE(model.rowOfAttendee(attendees.at(8)), 6);
+}
@@ -0,0 +1,122 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busybitmaptest.h"
+#include "busybitmap.h"
+
+#include <QTest>
+
+QTEST_GUILESS_MAIN(BusyBitmapTest)
+
+using namespace IncidenceEditorNG;
+
+void BusyBitmapTest::testSetRange_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("first");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("expectedFirst");
+    QTest::addColumn<int>("expectedCount");
+
+    QTest::newRow("inside one word") << 64 << 3 << 5 << 3 << 5;
+    QTest::newRow("whole word") << 128 << 64 << 64 << 64 << 64;
+    QTest::newRow("across words") << 200 << 60 << 80 << 60 << 80;
+    QTest::newRow("clipped at start") << 100 << -10 << 20 << 0 << 10;
+    QTest::newRow("clipped at end") << 100 << 90 << 20 << 90 << 10;
+    QTest::newRow("empty") << 100 << 10 << 0 << 0 << 0;
+    QTest::newRow("negative") << 100 << 10 << -1 << 0 << 0;
+    QTest::newRow("past the end") << 100 << 100 << 5 << 0 << 0;
+}
+
+void BusyBitmapTest::testSetRange()
+{
+    QFETCH(int, size);
+    QFETCH(int, first);
+    QFETCH(int, count);
+    QFETCH(int, expectedFirst);
+    QFETCH(int, expectedCount);
+
+    BusyBitmap bitmap(size);
+    bitmap.setRange(first, count);
+
+    QCOMPARE(bitmap.count(), expectedCount);
+    for (int i = 0; i < size; ++i) {
+        const bool expected = i >= expectedFirst && i < expectedFirst + expectedCount;
+        QCOMPARE(bitmap.testBit(i), expected);
+    }
+}
+
+void BusyBitmapTest::testScanning()
+{
+    BusyBitmap bitmap(300);
+    QCOMPARE(bitmap.nextSetBit(0), 300);
+    QCOMPARE(bitmap.nextClearBit(0), 0);
+
+    bitmap.setRange(10, 5);
+    bitmap.setRange(63, 130);
+    bitmap.setRange(250, 50);
+
+    QCOMPARE(bitmap.nextSetBit(0), 10);
+    QCOMPARE(bitmap.nextClearBit(10), 15);
+    QCOMPARE(bitmap.nextSetBit(15), 63);
+    QCOMPARE(bitmap.nextClearBit(63), 193);
+    QCOMPARE(bitmap.nextSetBit(193), 250);
+    QCOMPARE(bitmap.nextClearBit(250), 300);
+    QCOMPARE(bitmap.nextSetBit(300), 300);
+
+    bitmap.clear();
+    QCOMPARE(bitmap.count(), 0);
+    QCOMPARE(bitmap.size(), 300);
+}
+
+void BusyBitmapTest::testUnite()
+{
+    BusyBitmap a(130);
+    a.setRange(0, 10);
+    BusyBitmap b(130);
+    b.setRange(5, 10);
+    BusyBitmap c(130);
+    c.setRange(120, 10);
+
+    a.unite(b);
+    BusyBitmap expected(130);
+    expected.setRange(0, 15);
+    QVERIFY(a == expected);
+
+    a.unite(c);
+    QCOMPARE(a.count(), 25);
+    QCOMPARE(a.nextClearBit(0), 15);
+    QCOMPARE(a.nextSetBit(15), 120);
+}
+
+void BusyBitmapTest::testCounts()
+{
+    BusyBitmap a(130);
+    a.setRange(60, 10);
+    BusyBitmap b(130);
+    b.setRange(65, 10);
+
+    QVector<int> counts(130, 0);
+    a.addTo(counts, 3);
+    b.addTo(counts, 1);
+    QCOMPARE(counts.at(59), 0);
+    QCOMPARE(counts.at(60), 3);
+    QCOMPARE(counts.at(65), 4);
+    QCOMPARE(counts.at(70), 1);
+
+    BusyBitmap expected(130);
+    expected.setRange(60, 15);
+    QCOMPARE(BusyBitmap::fromCounts(counts), expected);
+
+    expected.clear();
+    expected.setRange(60, 10);
+    QCOMPARE(BusyBitmap::fromCounts(counts, 1), expected);
+
+    a.subtract(b);
+    expected.clear();
+    expected.setRange(60, 5);
+    QCOMPARE(a, expected);
+}
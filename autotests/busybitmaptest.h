@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class BusyBitmapTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSetRange_data();
+    void testSetRange();
+    void testScanning();
+    void testUnite();
+    void testCounts();
+};
+
@@ -0,0 +1,138 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busyintervalindextest.h"
+#include "busyintervalindex.h"
+
+#include <QTest>
+
+#include <limits>
+
+QTEST_GUILESS_MAIN(BusyIntervalIndexTest)
+
+using namespace IncidenceEditorNG;
+
+static const qint64 HOUR = 3600 * 1000;
+
+static QDateTime base()
+{
+    return QDateTime(QDate(2026, 3, 2), QTime(0, 0), Qt::UTC);
+}
+
+static KCalendarCore::Period hours(int from, int to)
+{
+    return KCalendarCore::Period(base().addSecs(from * 3600), base().addSecs(to * 3600));
+}
+
+void BusyIntervalIndexTest::testNextFree_data()
+{
+    QTest::addColumn<KCalendarCore::Period::List>("periods");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("duration");
+    QTest::addColumn<int>("expected");
+
+    const KCalendarCore::Period::List periods = {hours(9, 10), hours(11, 12), hours(12, 13), hours(15, 16)};
+    QTest::newRow("free") << periods << 6 << 2 << 6;
+    QTest::newRow("ends where busy starts") << periods << 7 << 2 << 7;
+    QTest::newRow("starts where busy ends") << periods << 10 << 1 << 10;
+    QTest::newRow("gap too small") << periods << 9 << 2 << 13;
+    QTest::newRow("touching periods") << periods << 11 << 1 << 13;
+    QTest::newRow("after all periods") << periods << 14 << 3 << 16;
+    QTest::newRow("no periods") << KCalendarCore::Period::List() << 14 << 3 << 14;
+    QTest::newRow("unsorted") << KCalendarCore::Period::List{hours(15, 16), hours(9, 10), hours(12, 13), hours(11, 12)} << 9 << 2 << 13;
+}
+
+void BusyIntervalIndexTest::testNextFree()
+{
+    QFETCH(KCalendarCore::Period::List, periods);
+    QFETCH(int, from);
+    QFETCH(int, duration);
+    QFETCH(int, expected);
+
+    const BusyIntervalIndex index(periods);
+    const qint64 start = base().toMSecsSinceEpoch();
+    QCOMPARE(index.nextFree(start + from * HOUR, duration * HOUR), start + expected * HOUR);
+}
+
+void BusyIntervalIndexTest::testMerging()
+{
+    const BusyIntervalIndex index({hours(9, 11), hours(10, 12), hours(12, 13), hours(9, 10)});
+    // touching intervals are kept apart
+    QCOMPARE(index.size(), 2);
+
+    const BusyIntervalIndex other({hours(11, 14), hours(20, 21)});
+    const BusyIntervalIndex united = BusyIntervalIndex::united({index, other});
+    QCOMPARE(united.size(), 2);
+
+    const qint64 start = base().toMSecsSinceEpoch();
+    QCOMPARE(united.nextFree(start + 9 * HOUR, HOUR), start + 14 * HOUR);
+    QCOMPARE(united.nextFree(start + 14 * HOUR, 7 * HOUR), start + 21 * HOUR);
+    QVERIFY(BusyIntervalIndex::united({}).isEmpty());
+}
+
+void BusyIntervalIndexTest::testTryDate()
+{
+    const BusyIntervalIndex index({hours(9, 10), hours(10, 12)});
+
+    QDateTime from = base().addSecs(8 * 3600);
+    QDateTime to = base().addSecs(9 * 3600);
+    QVERIFY(index.tryDate(from, to));
+    QCOMPARE(from, base().addSecs(8 * 3600));
+
+    to = base().addSecs(10 * 3600);
+    QVERIFY(!index.tryDate(from, to));
+    QCOMPARE(from, base().addSecs(12 * 3600));
+    QCOMPARE(to, base().addSecs(14 * 3600));
+    QVERIFY(index.tryDate(from, to));
+}
+
+void BusyIntervalIndexTest::testIntersects()
+{
+    const BusyIntervalIndex index({hours(9, 10), hours(12, 14)});
+    const qint64 start = base().toMSecsSinceEpoch();
+    const auto intersects = [&index, start](int from, int to) {
+        return index.intersects(start + from * HOUR, start + to * HOUR);
+    };
+
+    QVERIFY(!intersects(7, 8));
+    QVERIFY(!intersects(10, 11)); // starts where busy ends
+    QVERIFY(intersects(8, 9)); // ends where busy starts
+    QVERIFY(intersects(13, 15)); // busy laps into the range
+    QVERIFY(intersects(11, 15)); // busy lies within the range
+    QVERIFY(intersects(12, 13)); // the range lies within busy
+    QVERIFY(!intersects(14, 16));
+    QVERIFY(!BusyIntervalIndex().intersects(start, start + HOUR));
+}
+
+void BusyIntervalIndexTest::testNextBusy()
+{
+    const BusyIntervalIndex index({hours(9, 10), hours(12, 14)});
+    const qint64 start = base().toMSecsSinceEpoch();
+
+    QCOMPARE(index.nextBusy(start + 8 * HOUR), start + 9 * HOUR);
+    QCOMPARE(index.nextBusy(start + 9 * HOUR), start + 9 * HOUR);
+    QCOMPARE(index.nextBusy(start + 10 * HOUR), start + 12 * HOUR); // starts where busy ends
+    QCOMPARE(index.nextBusy(start + 13 * HOUR), start + 12 * HOUR);
+    QCOMPARE(index.nextBusy(start + 14 * HOUR), std::numeric_limits<qint64>::max());
+}
+
+void BusyIntervalIndexTest::testCursorNextChange()
+{
+    const BusyIntervalIndex index({hours(9, 10), hours(12, 14)});
+    BusyIntervalIndex::Cursor cursor(index);
+    const qint64 start = base().toMSecsSinceEpoch();
+
+    // a two hour range starts conflicting once it ends after 9
+    QVERIFY(!cursor.conflicts(start + 6 * HOUR, 2 * HOUR));
+    QCOMPARE(cursor.nextChange(start + 6 * HOUR, 2 * HOUR), start + 7 * HOUR + 1);
+
+    // and stops once it starts at 10
+    QVERIFY(cursor.conflicts(start + 8 * HOUR, 2 * HOUR));
+    QCOMPARE(cursor.nextChange(start + 8 * HOUR, 2 * HOUR), start + 10 * HOUR);
+
+    QVERIFY(!cursor.conflicts(start + 14 * HOUR, 2 * HOUR));
+    QCOMPARE(cursor.nextChange(start + 14 * HOUR, 2 * HOUR), std::numeric_limits<qint64>::max());
+}
@@ -0,0 +1,23 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class BusyIntervalIndexTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testNextFree_data();
+    void testNextFree();
+    void testMerging();
+    void testTryDate();
+    void testIntersects();
+    void testNextBusy();
+    void testCursorNextChange();
+};
+
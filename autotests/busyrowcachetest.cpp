@@ -0,0 +1,161 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busyrowcachetest.h"
+#include "busyrowcache.h"
+#include "slotgrid.h"
+
+#include <QTest>
+
+QTEST_GUILESS_MAIN(BusyRowCacheTest)
+
+using namespace IncidenceEditorNG;
+
+static const int RESOLUTION = 15 * 60;
+
+static QDateTime gridBegin()
+{
+    return QDateTime(QDate(2026, 3, 2), QTime(8, 0), Qt::UTC);
+}
+
+static QDateTime gridEnd()
+{
+    return gridBegin().addSecs(8 * 3600);
+}
+
+static KCalendarCore::FreeBusy::Ptr makeFreeBusy(int firstSlot, int slotCount)
+{
+    const QDateTime start = gridBegin().addSecs(firstSlot * RESOLUTION);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy(gridBegin(), gridEnd()));
+    fb->addPeriod(start, start.addSecs(slotCount * RESOLUTION));
+    return fb;
+}
+
+static QVector<int> expectedCounts(int range, const QVector<QPair<int, int>> &spans)
+{
+    QVector<int> counts(range, 0);
+    for (const auto &span : spans) {
+        for (int i = span.first; i < span.first + span.second; ++i) {
+            ++counts[i];
+        }
+    }
+    return counts;
+}
+
+void BusyRowCacheTest::testCounts()
+{
+    BusyRowCache cache(SlotGrid(gridBegin(), gridEnd(), RESOLUTION));
+    QCOMPARE(cache.range(), 32);
+
+    const auto fb1 = makeFreeBusy(2, 4);
+    const auto fb2 = makeFreeBusy(4, 4);
+    cache.beginUpdate();
+    cache.addFreeBusy(fb1);
+    cache.addFreeBusy(fb2);
+    cache.addFreeBusy(fb2); // the same attendee twice counts twice
+    cache.endUpdate();
+
+    QCOMPARE(cache.busyCounts(), expectedCounts(32, {{2, 4}, {4, 4}, {4, 4}}));
+
+    BusyBitmap busy(32);
+    busy.setRange(2, 6);
+    QCOMPARE(cache.busySlots(), busy);
+}
+
+void BusyRowCacheTest::testIncrementalUpdate()
+{
+    BusyRowCache cache(SlotGrid(gridBegin(), gridEnd(), RESOLUTION));
+
+    const auto fb1 = makeFreeBusy(0, 8);
+    const auto fb2 = makeFreeBusy(6, 4);
+    const auto fb3 = makeFreeBusy(20, 12);
+
+    cache.beginUpdate();
+    cache.addFreeBusy(fb1);
+    cache.addFreeBusy(fb2);
+    cache.endUpdate();
+    QCOMPARE(cache.busyCounts(), expectedCounts(32, {{0, 8}, {6, 4}}));
+
+    // the same rows again change nothing
+    const int revision = cache.revision();
+    cache.beginUpdate();
+    cache.addFreeBusy(fb2);
+    cache.addFreeBusy(fb1);
+    cache.endUpdate();
+    QCOMPARE(cache.revision(), revision);
+
+    // fb1 went, fb3 came
+    cache.beginUpdate();
+    cache.addFreeBusy(fb2);
+    cache.addFreeBusy(fb3);
+    cache.endUpdate();
+    QCOMPARE(cache.busyCounts(), expectedCounts(32, {{6, 4}, {20, 12}}));
+    QVERIFY(cache.revision() != revision);
+    BusyBitmap busy(32);
+    busy.setRange(6, 4);
+    busy.setRange(20, 12);
+    QCOMPARE(cache.busySlots(), busy);
+
+    // new free/busy data for the attendee of fb2 replaces the object
+    const auto fb2Updated = makeFreeBusy(10, 2);
+    cache.beginUpdate();
+    cache.addFreeBusy(fb2Updated);
+    cache.addFreeBusy(fb3);
+    cache.endUpdate();
+    QCOMPARE(cache.busyCounts(), expectedCounts(32, {{10, 2}, {20, 12}}));
+
+    cache.beginUpdate();
+    cache.endUpdate();
+    QCOMPARE(cache.busyCounts(), QVector<int>(32, 0));
+    QCOMPARE(cache.busySlots(), BusyBitmap(32));
+}
+
+void BusyRowCacheTest::testWeights()
+{
+    BusyRowCache cache(SlotGrid(gridBegin(), gridEnd(), RESOLUTION), /*weighted=*/true);
+    QVERIFY(cache.isWeighted());
+
+    const QDateTime start = gridBegin().addSecs(4 * RESOLUTION);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy(gridBegin(), gridEnd()));
+    KCalendarCore::FreeBusyPeriod busy(start, start.addSecs(4 * RESOLUTION));
+    busy.setType(KCalendarCore::FreeBusyPeriod::Busy);
+    KCalendarCore::FreeBusyPeriod tentative(start.addSecs(2 * RESOLUTION), start.addSecs(8 * RESOLUTION));
+    tentative.setType(KCalendarCore::FreeBusyPeriod::BusyTentative);
+    fb->addPeriods(KCalendarCore::FreeBusyPeriod::List() << busy << tentative);
+
+    cache.beginUpdate();
+    cache.addFreeBusy(fb, 4, 1);
+    cache.endUpdate();
+
+    // where busy and tentative overlap, the busy weight counts
+    QVector<int> expected(32, 0);
+    for (int i = 4; i < 8; ++i) {
+        expected[i] = 4;
+    }
+    for (int i = 8; i < 12; ++i) {
+        expected[i] = 1;
+    }
+    QCOMPARE(cache.busyCounts(), expected);
+
+    // changing the weights of a known row applies the difference
+    cache.beginUpdate();
+    cache.addFreeBusy(fb, 2, 2);
+    cache.endUpdate();
+    QCOMPARE(cache.busyCounts(), expectedCounts(32, {{4, 8}, {4, 8}}));
+}
+
+void BusyRowCacheTest::testGrid()
+{
+    const SlotGrid grid(gridBegin(), gridEnd(), RESOLUTION);
+    const BusyRowCache cache(grid);
+    QVERIFY(cache.grid() == grid);
+    QVERIFY(!(cache.grid() == SlotGrid(gridBegin(), gridEnd(), RESOLUTION * 2)));
+    QVERIFY(!(cache.grid() == SlotGrid(gridBegin().addDays(1), gridEnd(), RESOLUTION)));
+
+    // a missing FreeBusy object has no busy slots
+    QCOMPARE(cache.busyRow(KCalendarCore::FreeBusy::Ptr()), BusyBitmap(32));
+    QCOMPARE(BusyRowCache().range(), 0);
+}
@@ -0,0 +1,20 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class BusyRowCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCounts();
+    void testIncrementalUpdate();
+    void testWeights();
+    void testGrid();
+};
+
@@ -7,11 +7,17 @@
 
 #include "conflictresolvertest.h"
 #include "conflictresolver.h"
+#include "freebusycache.h"
+
+#include <CalendarSupport/FreeBusyItemModel>
 
 #include <KCalendarCore/Duration>
 #include <KCalendarCore/Event>
 #include <KCalendarCore/Period>
 
+#include <QBitArray>
+#include <QSignalSpy>
+#include <QStandardPaths>
 #include <QTest>
 #include <QWidget>
 
@@ -35,6 +41,8 @@ void ConflictResolverTest::addAttendee(const QString &email, const KCalendarCore
 
 void ConflictResolverTest::initTestCase()
 {
+    // Keep the free/busy cache of the user out of it
+    QStandardPaths::setTestModeEnabled(true);
     parent = new QWidget;
     init();
 }
@@ -44,6 +52,8 @@ void ConflictResolverTest::init()
     base = QDateTime::currentDateTime().addDays(1);
     end = base.addSecs(10 * 60 * 60);
     resolver = new ConflictResolver(parent, parent);
+    // Don't let the cache of an earlier run or test supply free/busy data
+    FreeBusyCache::instance()->clear();
 }
 
 void ConflictResolverTest::cleanup()
@@ -51,6 +61,7 @@ void ConflictResolverTest::cleanup()
     delete resolver;
     resolver = nullptr;
     attendees.clear();
+    FreeBusyCache::instance()->clear();
 }
 
 void ConflictResolverTest::simpleTest()
@@ -284,4 +295,352 @@ void ConflictResolverTest::testPeriodEndsAtSametimeAsTimeframe()
     QCOMPARE(resolver->availableSlots().size(), 0);
 }
 
+void ConflictResolverTest::testIntervalSweepMatchesSlotMatrix()
+{
+    // 2010-07-29 is a Thursday, so the timeframe spans a weekend
+    base.setDate(QDate(2010, 7, 29));
+    base.setTime(QTime(7, 10));
+    end = base.addDays(5);
+
+    KCalendarCore::Period::List periods1;
+    KCalendarCore::Period::List periods2;
+    for (int day = 0; day < 5; ++day) {
+        const QDateTime morning = base.addDays(day).addSecs(2 * 60 * 60 + 7 * 60);
+        periods1 << KCalendarCore::Period(morning, morning.addSecs(50 * 60));
+        periods2 << KCalendarCore::Period(morning.addSecs(40 * 60), morning.addSecs(3 * 60 * 60 + 1));
+    }
+    // overlapping the beginning and the end of the timeframe
+    periods1 << KCalendarCore::Period(base.addSecs(-60 * 60), base.addSecs(12 * 60));
+    periods2 << KCalendarCore::Period(end.addSecs(-17 * 60), end.addSecs(60 * 60));
+
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"), KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(periods1)));
+    addAttendee(QStringLiteral("kdabtest2@demo.kolab.org"), KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(periods2)));
+
+    insertAttendees();
+
+    QBitArray weekdays(7, true);
+    weekdays.clearBit(5); // Saturday
+    weekdays.clearBit(6); // Sunday
+    resolver->setAllowedWeekdays(weekdays);
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+
+    for (int resolution : {60, 5 * 60, 15 * 60}) {
+        resolver->setResolution(resolution);
+
+        resolver->setFreeSlotAlgorithm(ConflictResolver::SlotMatrix);
+        resolver->findAllFreeSlots();
+        const KCalendarCore::Period::List matrixSlots = resolver->availableSlots();
+
+        resolver->setFreeSlotAlgorithm(ConflictResolver::IntervalSweep);
+        resolver->findAllFreeSlots();
+        const KCalendarCore::Period::List sweepSlots = resolver->availableSlots();
+
+        QVERIFY(!matrixSlots.isEmpty());
+        QCOMPARE(sweepSlots, matrixSlots);
+    }
+}
+
+void ConflictResolverTest::testBackgroundSearch()
+{
+    base.setDate(QDate(2010, 7, 29));
+    base.setTime(QTime(7, 30));
+
+    end.setDate(QDate(2010, 7, 29));
+    end.setTime(QTime(9, 30));
+
+    KCalendarCore::Period testEvent(_time(8, 00), _time(9, 45));
+
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << testEvent)));
+
+    insertAttendees();
+
+    QSignalSpy spy(resolver, &ConflictResolver::freeSlotsAvailable);
+    // Only the search for the last constraints is reported
+    resolver->setEarliestDateTime(base.addSecs(-60 * 60));
+    resolver->setLatestDateTime(end.addSecs(60 * 60));
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+
+    const auto freeSlots = spy.at(0).at(0).value<KCalendarCore::Period::List>();
+    QCOMPARE(freeSlots.size(), 1);
+    QCOMPARE(freeSlots.at(0).start(), base);
+    QCOMPARE(freeSlots.at(0).end(), _time(8, 00));
+    QCOMPARE(resolver->availableSlots(), freeSlots);
+}
+
+void ConflictResolverTest::testRankedFreeSlots()
+{
+    base.setTime(QTime(8, 0));
+
+    // the chair is busy 9-11, the optional participant 11-12
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(9, 00), _time(11, 00)))),
+                KCalendarCore::Attendee::Chair);
+    addAttendee(QStringLiteral("kdabtest2@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(11, 00), _time(12, 00)))),
+                KCalendarCore::Attendee::OptParticipant);
+
+    insertAttendees();
+
+    resolver->setMandatoryRoles({KCalendarCore::Attendee::Chair});
+    resolver->setResolution(60 * 60);
+    resolver->setWorkingHours(QTime(8, 0), QTime(17, 0));
+
+    const KCalendarCore::Period request(_time(9, 00), _time(10, 00));
+    const auto candidates = resolver->rankedFreeSlots(request, 3);
+    QCOMPARE(candidates.size(), 3);
+
+    // 11:00 conflicts with the optional participant, so 12:00 and 13:00
+    // are rated better even though they are farther away
+    QCOMPARE(candidates.at(0).period.start(), _time(12, 00));
+    QCOMPARE(candidates.at(0).busyOptionalAttendees, 0);
+    QCOMPARE(candidates.at(1).period.start(), _time(13, 00));
+    QCOMPARE(candidates.at(2).period.start(), _time(14, 00));
+    for (const auto &candidate : candidates) {
+        QVERIFY(candidate.withinWorkingHours);
+        QCOMPARE(candidate.period.end(), candidate.period.start().addSecs(60 * 60));
+    }
+
+    // a custom cost function only caring about the distance
+    resolver->setSlotCostFunction([](const ConflictResolver::SlotCandidate &candidate) {
+        return double(candidate.secsFromRequest);
+    });
+    const auto nearest = resolver->rankedFreeSlots(request, 1);
+    QCOMPARE(nearest.size(), 1);
+    QCOMPARE(nearest.at(0).period.start(), _time(11, 00));
+    QCOMPARE(nearest.at(0).busyOptionalAttendees, 1);
+    QCOMPARE(nearest.at(0).cost, 2 * 60 * 60.0);
+}
+
+void ConflictResolverTest::testSearchHorizon()
+{
+    base.setTime(QTime(8, 0));
+
+    // busy for the next ten days
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(base, base.addDays(10)))));
+
+    insertAttendees();
+
+    const KCalendarCore::Period request(base, base.addSecs(60 * 60));
+    QCOMPARE(resolver->searchHorizon(), 365);
+    QVERIFY(!resolver->rankedFreeSlots(request, 1).isEmpty());
+
+    resolver->setSearchHorizon(5);
+    QVERIFY(resolver->rankedFreeSlots(request, 1).isEmpty());
+
+    // negative horizons are ignored
+    resolver->setSearchHorizon(-1);
+    QCOMPARE(resolver->searchHorizon(), 5);
+}
+
+void ConflictResolverTest::testWorkingHours()
+{
+    base.setTime(QTime(8, 0));
+
+    // busy until 23:00
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(base, _time(23, 00)))));
+
+    insertAttendees();
+
+    resolver->setResolution(60 * 60);
+    resolver->setWorkingHours(QTime(18, 0), QTime(0, 0));
+
+    // a slot ending right at midnight is within working hours ending at midnight
+    const KCalendarCore::Period request(base, base.addSecs(60 * 60));
+    auto candidates = resolver->rankedFreeSlots(request, 2);
+    QCOMPARE(candidates.size(), 2);
+    QCOMPARE(candidates.at(0).period.start(), _time(23, 00));
+    QVERIFY(candidates.at(0).withinWorkingHours);
+    QCOMPARE(candidates.at(1).period.start(), base.addDays(1).addSecs(10 * 60 * 60));
+    QVERIFY(candidates.at(1).withinWorkingHours);
+
+    // working hours ending before they start are ignored
+    resolver->setWorkingHours(QTime(17, 0), QTime(8, 0));
+    candidates = resolver->rankedFreeSlots(request, 1);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates.at(0).period.start(), _time(23, 00));
+    QVERIFY(candidates.at(0).withinWorkingHours);
+}
+
+void ConflictResolverTest::testWeightedConflicts()
+{
+    base.setTime(QTime(8, 0));
+    end = base.addSecs(4 * 60 * 60);
+
+    // nobody is free at the same time: the chair is busy 8-10, the optional
+    // participant 10-12, and the required participant tentatively 11-12
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(8, 00), _time(10, 00)))),
+                KCalendarCore::Attendee::Chair);
+    addAttendee(QStringLiteral("kdabtest2@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(10, 00), _time(12, 00)))),
+                KCalendarCore::Attendee::OptParticipant);
+    KCalendarCore::FreeBusyPeriod tentative(_time(11, 00), _time(12, 00));
+    tentative.setType(KCalendarCore::FreeBusyPeriod::BusyTentative);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy(base, end));
+    fb->addPeriods(KCalendarCore::FreeBusyPeriod::List() << tentative);
+    addAttendee(QStringLiteral("kdabtest3@demo.kolab.org"), fb, KCalendarCore::Attendee::ReqParticipant);
+
+    insertAttendees();
+
+    resolver->setResolution(15 * 60);
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots().size(), 0);
+
+    resolver->setWeightedConflicts(true);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots().size(), 1);
+    QCOMPARE(resolver->availableSlots().at(0).start(), _time(10, 00));
+    QCOMPARE(resolver->availableSlots().at(0).end(), _time(11, 00));
+    QCOMPARE(resolver->availableSlotsCost(), double(resolver->roleWeight(KCalendarCore::Attendee::OptParticipant)));
+
+    // tentative conflicts weigh nothing now
+    resolver->setTentativeWeightPercent(0);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots().size(), 1);
+    QCOMPARE(resolver->availableSlots().at(0).start(), _time(10, 00));
+    QCOMPARE(resolver->availableSlots().at(0).end(), _time(12, 00));
+    QCOMPARE(resolver->availableSlotsCost(), double(resolver->roleWeight(KCalendarCore::Attendee::OptParticipant)));
+
+    // half of a weight of 1 still counts
+    resolver->setRoleWeight(KCalendarCore::Attendee::ReqParticipant, 1);
+    resolver->setRoleWeight(KCalendarCore::Attendee::OptParticipant, 0);
+    resolver->setTentativeWeightPercent(50);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots().size(), 1);
+    QCOMPARE(resolver->availableSlots().at(0).start(), _time(10, 00));
+    QCOMPARE(resolver->availableSlots().at(0).end(), _time(11, 00));
+    QCOMPARE(resolver->availableSlotsCost(), 0.0);
+    QCOMPARE(resolver->busyCounts().at(12), 50);
+}
+
+void ConflictResolverTest::testAllowedHours()
+{
+    // Friday to Tuesday
+    base = QDateTime(QDate(2010, 7, 30), QTime(0, 0));
+    end = base.addDays(4);
+
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(12, 00), _time(13, 00)))));
+
+    insertAttendees();
+
+    QBitArray weekdays(7, true);
+    weekdays.clearBit(5); // Saturday
+    weekdays.clearBit(6); // Sunday
+    resolver->setAllowedWeekdays(weekdays);
+    resolver->setAllowedHours(QTime(9, 0), QTime(17, 0));
+    resolver->setAllowedHours(0, QTime(10, 10), QTime(11, 50)); // Monday
+    resolver->setResolution(15 * 60);
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+
+    const KCalendarCore::Period::List expected = {KCalendarCore::Period(_time(9, 00), _time(12, 00)),
+                                                  KCalendarCore::Period(_time(13, 00), _time(17, 00)),
+                                                  // only the slots completely within the hours
+                                                  KCalendarCore::Period(base.addDays(3).addSecs(10 * 60 * 60 + 15 * 60), base.addDays(3).addSecs(11 * 60 * 60 + 45 * 60))};
+
+    resolver->setFreeSlotAlgorithm(ConflictResolver::SlotMatrix);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots(), expected);
+
+    resolver->setFreeSlotAlgorithm(ConflictResolver::IntervalSweep);
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots(), expected);
+}
+
+void ConflictResolverTest::testBusyCounts()
+{
+    base.setTime(QTime(8, 0));
+    end = base.addSecs(2 * 60 * 60);
+
+    addAttendee(QStringLiteral("kdabtest1@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(8, 00), _time(9, 00)))));
+    addAttendee(QStringLiteral("kdabtest2@demo.kolab.org"),
+                KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << KCalendarCore::Period(_time(8, 30), _time(9, 30)))));
+    insertAttendees();
+
+    QSignalSpy spy(resolver, &ConflictResolver::busyCountsChanged);
+    resolver->setResolution(30 * 60);
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+    resolver->findAllFreeSlots();
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(resolver->busyCountsGrid() == SlotGrid(base, end, 30 * 60));
+    QCOMPARE(resolver->busyCounts(), QVector<int>({1, 2, 1, 0}));
+
+    // the same result again changes nothing
+    resolver->findAllFreeSlots();
+    QCOMPARE(spy.count(), 1);
+
+    // the sweep does not count
+    resolver->setFreeSlotAlgorithm(ConflictResolver::IntervalSweep);
+    resolver->findAllFreeSlots();
+    QCOMPARE(spy.count(), 2);
+    QVERIFY(resolver->busyCounts().isEmpty());
+}
+
+void ConflictResolverTest::testSetAttendees()
+{
+    const KCalendarCore::Period meeting(base.addSecs(60 * 60), KCalendarCore::Duration(60 * 60));
+    const KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << meeting));
+    addAttendee(QStringLiteral("albert@einstein.net"), fb);
+    addAttendee(QStringLiteral("niels@bohr.net"), fb);
+    addAttendee(QStringLiteral("max@planck.net"), fb);
+    insertAttendees();
+    QAbstractItemModel *model = resolver->model();
+    QCOMPARE(model->rowCount(), 3);
+
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy conflictSpy(resolver, &ConflictResolver::conflictsDetected);
+
+    // the same attendees in another order change nothing
+    resolver->setAttendees({attendees.at(2)->attendee(), attendees.at(0)->attendee(), attendees.at(1)->attendee()});
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+    QCOMPARE(conflictSpy.count(), 0);
+
+    // removing two recalculates the conflicts once and keeps the free/busy data of the rest
+    resolver->setAttendees({attendees.at(1)->attendee()});
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(conflictSpy.count(), 1);
+    const QModelIndex index = model->index(0, 0);
+    QCOMPARE(model->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>(), attendees.at(1)->attendee());
+    QVERIFY(model->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>());
+
+    resolver->removeAttendees({attendees.at(1)->attendee()});
+    QCOMPARE(model->rowCount(), 0);
+    QCOMPARE(conflictSpy.count(), 2);
+}
+
+void ConflictResolverTest::testCachedFreeBusy()
+{
+    KCalendarCore::Period meeting(base.addSecs(60 * 60), KCalendarCore::Duration(2 * 60 * 60));
+    FreeBusyCache::instance()->insert(QStringLiteral("cached@example.com"),
+                                      KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::Period::List() << meeting)));
+    resolver->setEarliestDateTime(base);
+    resolver->setLatestDateTime(end);
+
+    // the cached data is there right away, without waiting for a download
+    resolver->insertAttendee(KCalendarCore::Attendee(QStringLiteral("Cached"), QStringLiteral("cached@example.com")));
+    CalendarSupport::FreeBusyItemModel *model = resolver->model();
+    QCOMPARE(model->rowCount(), 1);
+    QVERIFY(model->data(model->index(0, 0), CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>());
+
+    resolver->findAllFreeSlots();
+    QCOMPARE(resolver->availableSlots().size(), 2);
+    QCOMPARE(resolver->availableSlots().at(0).start(), base);
+}
+
 QTEST_MAIN(ConflictResolverTest)
@@ -33,6 +33,16 @@ private Q_SLOTS:
     void testPeriodEndsAfterTimeframeEnds();
     void testPeriodIsLargerThenTimeframe();
     void testPeriodEndsAtSametimeAsTimeframe();
+    void testIntervalSweepMatchesSlotMatrix();
+    void testBackgroundSearch();
+    void testRankedFreeSlots();
+    void testSearchHorizon();
+    void testWorkingHours();
+    void testWeightedConflicts();
+    void testAllowedHours();
+    void testBusyCounts();
+    void testSetAttendees();
+    void testCachedFreeBusy();
 
 private:
     void insertAttendees();
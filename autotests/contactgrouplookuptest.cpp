@@ -0,0 +1,95 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "contactgrouplookuptest.h"
+#include "contactgrouplookup.h"
+
+#include <QTest>
+
+QTEST_GUILESS_MAIN(ContactGroupLookupTest)
+
+using namespace IncidenceEditorNG;
+
+class TestLookup : public ContactGroupLookup
+{
+public:
+    TestLookup()
+    {
+        connect(this, &ContactGroupLookup::groupsFound, this, [this](const QString &name, const KContacts::ContactGroup::List &groups) {
+            found.append({name, groups.size()});
+        });
+    }
+
+    using ContactGroupLookup::groupsSearched;
+
+    QVector<QStringList> searches;
+    QVector<QPair<QString, int>> found;
+
+protected:
+    void search(const QStringList &names) override
+    {
+        QStringList sorted = names;
+        sorted.sort();
+        searches.append(sorted);
+    }
+};
+
+void ContactGroupLookupTest::testBatching()
+{
+    TestLookup lookup;
+    lookup.lookup(QStringLiteral("team"));
+    lookup.lookup(QStringLiteral("board"));
+    QTest::qWait(50);
+    lookup.lookup(QStringLiteral("team"));
+    lookup.lookup(QString());
+    QVERIFY(lookup.searches.isEmpty());
+
+    // one search once no name came in for a while
+    QTRY_COMPARE(lookup.searches.size(), 1);
+    QCOMPARE(lookup.searches.at(0), QStringList({QStringLiteral("board"), QStringLiteral("team")}));
+
+    // names still searched for are not searched again
+    lookup.lookup(QStringLiteral("team"));
+    lookup.lookup(QStringLiteral("staff"));
+    QTRY_COMPARE(lookup.searches.size(), 2);
+    QCOMPARE(lookup.searches.at(1), QStringList({QStringLiteral("staff")}));
+}
+
+void ContactGroupLookupTest::testCache()
+{
+    TestLookup lookup;
+    lookup.lookup(QStringLiteral("Team"));
+    lookup.lookup(QStringLiteral("board"));
+    QTRY_COMPARE(lookup.searches.size(), 1);
+
+    lookup.groupsSearched(lookup.searches.at(0), {KContacts::ContactGroup(QStringLiteral("team"))}, false);
+    QCOMPARE(lookup.found.size(), 2);
+    QVERIFY(lookup.found.contains({QStringLiteral("Team"), 1}));
+    QVERIFY(lookup.found.contains({QStringLiteral("board"), 0}));
+
+    // found and not found names are answered from the cache, ignoring case
+    lookup.found.clear();
+    lookup.lookup(QStringLiteral("team"));
+    lookup.lookup(QStringLiteral("board"));
+    QTRY_COMPARE(lookup.found.size(), 2);
+    QVERIFY(lookup.found.contains({QStringLiteral("team"), 1}));
+    QVERIFY(lookup.found.contains({QStringLiteral("board"), 0}));
+    QCOMPARE(lookup.searches.size(), 1);
+}
+
+void ContactGroupLookupTest::testFailedSearch()
+{
+    TestLookup lookup;
+    lookup.lookup(QStringLiteral("team"));
+    QTRY_COMPARE(lookup.searches.size(), 1);
+
+    lookup.groupsSearched(lookup.searches.at(0), {}, true);
+    QCOMPARE(lookup.found, (QVector<QPair<QString, int>>{{QStringLiteral("team"), 0}}));
+
+    // failures are not cached
+    lookup.lookup(QStringLiteral("team"));
+    QTRY_COMPARE(lookup.searches.size(), 2);
+}
@@ -0,0 +1,135 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "deferredincidenceeditortest.h"
+#include "deferredincidenceeditor.h"
+
+#include <KCalendarCore/Event>
+
+#include <QSignalSpy>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(DeferredIncidenceEditorTest)
+
+using namespace IncidenceEditorNG;
+
+class SummaryEditor : public IncidenceEditor
+{
+public:
+    using IncidenceEditor::load;
+    using IncidenceEditor::save;
+
+    void load(const KCalendarCore::Incidence::Ptr &incidence) override
+    {
+        mLoadedIncidence = incidence;
+        summary = incidence->summary();
+        mWasDirty = false;
+    }
+
+    void save(const KCalendarCore::Incidence::Ptr &incidence) override
+    {
+        incidence->setSummary(summary);
+    }
+
+    bool isDirty() const override
+    {
+        return summary != mLoadedIncidence->summary();
+    }
+
+    bool isValid() const override
+    {
+        mLastErrorString = summary.isEmpty() ? QStringLiteral("empty") : QString();
+        return !summary.isEmpty();
+    }
+
+    void setSummary(const QString &text)
+    {
+        summary = text;
+        scheduleDirtyCheck();
+    }
+
+    QString summary;
+};
+
+static KCalendarCore::Incidence::Ptr createEvent(const QString &summary)
+{
+    KCalendarCore::Incidence::Ptr event(new KCalendarCore::Event);
+    event->setSummary(summary);
+    return event;
+}
+
+void DeferredIncidenceEditorTest::testUnmaterialized()
+{
+    int created = 0;
+    DeferredIncidenceEditor editor([&created]() {
+        ++created;
+        return new SummaryEditor;
+    });
+
+    editor.load(createEvent(QString()));
+    QVERIFY(!editor.isMaterialized());
+    QVERIFY(!editor.editor());
+    QVERIFY(!editor.isDirty());
+    QVERIFY(editor.isValid());
+    QCOMPARE(editor.type(), KCalendarCore::Incidence::TypeEvent);
+
+    // the copy of the loaded incidence keeps its values
+    const KCalendarCore::Incidence::Ptr copy = createEvent(QStringLiteral("meeting"));
+    editor.save(copy);
+    QCOMPARE(copy->summary(), QStringLiteral("meeting"));
+    QCOMPARE(created, 0);
+}
+
+void DeferredIncidenceEditorTest::testMaterialize()
+{
+    int created = 0;
+    DeferredIncidenceEditor editor([&created]() {
+        ++created;
+        return new SummaryEditor;
+    });
+    QSignalSpy spy(&editor, &DeferredIncidenceEditor::materialized);
+
+    editor.load(createEvent(QStringLiteral("meeting")));
+    auto summaryEditor = static_cast<SummaryEditor *>(editor.materialize());
+    QCOMPARE(editor.materialize(), summaryEditor);
+    QCOMPARE(editor.editor(), summaryEditor);
+    QCOMPARE(created, 1);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(summaryEditor->summary, QStringLiteral("meeting"));
+    QVERIFY(!editor.isDirty());
+
+    summaryEditor->setSummary(QString());
+    QVERIFY(editor.isDirty());
+    QVERIFY(!editor.isValid());
+    QCOMPARE(editor.lastErrorString(), QStringLiteral("empty"));
+
+    // later loads go to the created editor
+    editor.load(createEvent(QStringLiteral("lunch")));
+    QCOMPARE(summaryEditor->summary, QStringLiteral("lunch"));
+    QVERIFY(!editor.isDirty());
+
+    const KCalendarCore::Incidence::Ptr event = createEvent(QString());
+    editor.save(event);
+    QCOMPARE(event->summary(), QStringLiteral("lunch"));
+}
+
+void DeferredIncidenceEditorTest::testDirtyStatusForwarded()
+{
+    DeferredIncidenceEditor editor([]() {
+        return new SummaryEditor;
+    });
+    editor.load(createEvent(QStringLiteral("meeting")));
+    auto summaryEditor = static_cast<SummaryEditor *>(editor.materialize());
+    QSignalSpy spy(&editor, &IncidenceEditor::dirtyStatusChanged);
+
+    summaryEditor->setSummary(QStringLiteral("lunch"));
+    QCOMPARE(spy.count(), 0);
+
+    // flushing the stand-in runs the check scheduled by the created editor
+    editor.flushDirtyStatus();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toBool(), true);
+}
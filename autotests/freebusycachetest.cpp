@@ -0,0 +1,117 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "freebusycachetest.h"
+#include "freebusycache.h"
+
+#include <KCalendarCore/FreeBusyPeriod>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(FreeBusyCacheTest)
+
+using namespace IncidenceEditorNG;
+
+static KCalendarCore::FreeBusy::Ptr freeBusy()
+{
+    const QDateTime start(QDate(2026, 3, 2), QTime(9, 0), Qt::UTC);
+    KCalendarCore::FreeBusyPeriod busy(start, start.addSecs(60 * 60));
+    busy.setType(KCalendarCore::FreeBusyPeriod::Busy);
+    KCalendarCore::FreeBusyPeriod tentative(start.addDays(1), start.addDays(1).addSecs(30 * 60));
+    tentative.setType(KCalendarCore::FreeBusyPeriod::BusyTentative);
+    return KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(KCalendarCore::FreeBusyPeriod::List{busy, tentative}));
+}
+
+void FreeBusyCacheTest::testRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("cache/freebusycache"));
+
+    {
+        FreeBusyCache cache(fileName);
+        QVERIFY(!cache.freeBusy(QStringLiteral("albert@einstein.net")));
+        cache.insert(QStringLiteral("Albert@Einstein.net"), freeBusy());
+        QVERIFY(cache.save());
+    }
+
+    FreeBusyCache cache(fileName);
+    bool fresh = false;
+    const KCalendarCore::FreeBusy::Ptr cached = cache.freeBusy(QStringLiteral("albert@einstein.net"), &fresh);
+    QVERIFY(cached);
+    QVERIFY(fresh);
+    const KCalendarCore::FreeBusyPeriod::List expected = freeBusy()->fullBusyPeriods();
+    const KCalendarCore::FreeBusyPeriod::List periods = cached->fullBusyPeriods();
+    QCOMPARE(periods.size(), expected.size());
+    for (int i = 0; i < periods.size(); ++i) {
+        QCOMPARE(periods.at(i).start(), expected.at(i).start());
+        QCOMPARE(periods.at(i).end(), expected.at(i).end());
+        QCOMPARE(periods.at(i).type(), expected.at(i).type());
+    }
+    QVERIFY(!cache.freeBusy(QStringLiteral("niels@bohr.net")));
+}
+
+void FreeBusyCacheTest::testFreshness()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    FreeBusyCache cache(dir.filePath(QStringLiteral("freebusycache")));
+    cache.insert(QStringLiteral("albert@einstein.net"), freeBusy());
+
+    bool fresh = false;
+    QVERIFY(cache.freeBusy(QStringLiteral("albert@einstein.net"), &fresh));
+    QVERIFY(fresh);
+
+    // stale data is still handed out, but has to be fetched again
+    cache.setTimeToLive(0);
+    QVERIFY(cache.freeBusy(QStringLiteral("albert@einstein.net"), &fresh));
+    QVERIFY(!fresh);
+}
+
+void FreeBusyCacheTest::testDamagedFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("freebusycache"));
+    {
+        FreeBusyCache cache(fileName);
+        cache.insert(QStringLiteral("albert@einstein.net"), freeBusy());
+        QVERIFY(cache.save());
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5));
+    file.close();
+
+    FreeBusyCache cache(fileName);
+    QVERIFY(!cache.freeBusy(QStringLiteral("albert@einstein.net")));
+}
+
+void FreeBusyCacheTest::testClear()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("freebusycache"));
+    {
+        FreeBusyCache cache(fileName);
+        cache.insert(QStringLiteral("albert@einstein.net"), freeBusy());
+        QVERIFY(cache.save());
+    }
+
+    // clearing a cache which didn't read the file yet empties the file too
+    {
+        FreeBusyCache cache(fileName);
+        cache.clear();
+        QVERIFY(!cache.freeBusy(QStringLiteral("albert@einstein.net")));
+        QVERIFY(cache.save());
+    }
+
+    FreeBusyCache cache(fileName);
+    QVERIFY(!cache.freeBusy(QStringLiteral("albert@einstein.net")));
+}
@@ -88,6 +88,39 @@ private Q_SLOTS:
 
         QLocale::setDefault(currentLocale);
     }
+
+    void testWeeklyRecurrenceFollowsStartDate()
+    {
+        // A weekly event on Wednesdays
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        event->setSummary(QStringLiteral("e"));
+        event->setDtStart(QDateTime(QDate(2000, 1, 12), QTime(10, 0)));
+        event->setDtEnd(QDateTime(QDate(2000, 1, 12), QTime(11, 0)));
+        QBitArray days(7);
+        days.setBit(Qt::Wednesday - 1);
+        event->recurrence()->setWeekly(1, days);
+
+        Akonadi::Item item;
+        item.setPayload<KCalendarCore::Event::Ptr>(event);
+        auto dialog = new IncidenceDialog();
+        dialog->load(item);
+        auto editor = dialog->findChild<IncidenceEditor *>();
+        QVERIFY2(editor, "Couldn't find the combined editor.");
+
+        // Move it to Thursday without ever showing the recurrence tab
+        auto startDate = dialog->findChild<KDateComboBox *>(QStringLiteral("mStartDateEdit"));
+        QVERIFY2(startDate, "Couldn't find start date field.");
+        startDate->setDate(QDate(2000, 1, 13));
+
+        KCalendarCore::Incidence::Ptr saved(event->clone());
+        editor->save(saved);
+        QCOMPARE(saved->dtStart().date(), QDate(2000, 1, 13));
+        const QBitArray savedDays = saved->recurrence()->days();
+        QVERIFY(savedDays.testBit(Qt::Thursday - 1));
+        QVERIFY(!savedDays.testBit(Qt::Wednesday - 1));
+
+        delete dialog;
+    }
 };
 
 QTEST_MAIN(IncidenceDateTimeTest)
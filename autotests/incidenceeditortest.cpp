@@ -0,0 +1,138 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "incidenceeditortest.h"
+#include "combinedincidenceeditor.h"
+
+#include <KCalendarCore/Event>
+
+#include <QSignalSpy>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(IncidenceEditorTest)
+
+using namespace IncidenceEditorNG;
+
+class FieldEditor : public IncidenceEditor
+{
+public:
+    using IncidenceEditor::load;
+    using IncidenceEditor::save;
+
+    FieldEditor()
+    {
+        setDirtyCheck([this](uint changedFields) {
+            checks.append(changedFields);
+            return dirty;
+        });
+    }
+
+    void load(const KCalendarCore::Incidence::Ptr &incidence) override
+    {
+        mLoadedIncidence = incidence;
+        mWasDirty = false;
+    }
+
+    void save(const KCalendarCore::Incidence::Ptr &incidence) override
+    {
+        Q_UNUSED(incidence)
+    }
+
+    bool isDirty() const override
+    {
+        return dirty;
+    }
+
+    void change(uint fields)
+    {
+        fieldsChanged(fields);
+    }
+
+    QVector<uint> checks;
+    bool dirty = false;
+};
+
+void IncidenceEditorTest::testCoalescedDirtyCheck()
+{
+    FieldEditor editor;
+    editor.load(KCalendarCore::Incidence::Ptr(new KCalendarCore::Event));
+    QSignalSpy spy(&editor, &IncidenceEditor::dirtyStatusChanged);
+
+    editor.dirty = true;
+    editor.change(0x1);
+    editor.change(0x2);
+    editor.change(0x1);
+    QVERIFY(editor.checks.isEmpty());
+    QCOMPARE(spy.count(), 0);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(editor.checks, QVector<uint>({0x3}));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toBool(), true);
+
+    // checkDirtyStatus() re-checks everything right away, and replaces the
+    // check scheduled before
+    editor.dirty = false;
+    editor.change(0x2);
+    editor.checkDirtyStatus();
+    QCOMPARE(editor.checks, QVector<uint>({0x3, ~0u}));
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(1).at(0).toBool(), false);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(editor.checks.size(), 2);
+    QCOMPARE(spy.count(), 2);
+}
+
+void IncidenceEditorTest::testFlushDirtyStatus()
+{
+    FieldEditor editor;
+    editor.load(KCalendarCore::Incidence::Ptr(new KCalendarCore::Event));
+    QSignalSpy spy(&editor, &IncidenceEditor::dirtyStatusChanged);
+
+    editor.dirty = true;
+    editor.change(0x1);
+    editor.flushDirtyStatus();
+    QCOMPARE(editor.checks, QVector<uint>({0x1}));
+    QCOMPARE(spy.count(), 1);
+
+    // the scheduled check has already run
+    QCoreApplication::processEvents();
+    QCOMPARE(editor.checks.size(), 1);
+
+    // nothing scheduled, nothing to do
+    editor.flushDirtyStatus();
+    QCOMPARE(editor.checks.size(), 1);
+}
+
+void IncidenceEditorTest::testCombinedReset()
+{
+    CombinedIncidenceEditor combined;
+    auto editor = new FieldEditor;
+    combined.combine(editor);
+    combined.load(KCalendarCore::Incidence::Ptr(new KCalendarCore::Event));
+    QSignalSpy spy(&combined, &IncidenceEditor::dirtyStatusChanged);
+
+    // the scheduled check runs, but doesn't count
+    editor->dirty = true;
+    editor->change(0x1);
+    combined.reset();
+    QVERIFY(!combined.incidence<KCalendarCore::Incidence>());
+    QVERIFY(!combined.isDirty());
+    QCOMPARE(editor->checks, QVector<uint>({0x1}));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toBool(), false);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 1);
+
+    // the combined editor is used again after the next load
+    editor->dirty = false;
+    combined.load(KCalendarCore::Incidence::Ptr(new KCalendarCore::Event));
+    editor->dirty = true;
+    editor->change(0x2);
+    QVERIFY(combined.isDirty());
+}
@@ -0,0 +1,106 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "slotgridtest.h"
+#include "slotgrid.h"
+
+#include <QTest>
+#include <QTimeZone>
+
+QTEST_GUILESS_MAIN(SlotGridTest)
+
+using namespace IncidenceEditorNG;
+
+static const int RESOLUTION = 15 * 60;
+
+static QDateTime utc(int hour, int minute)
+{
+    return QDateTime(QDate(2026, 3, 2), QTime(hour, minute), Qt::UTC);
+}
+
+void SlotGridTest::testSlotSpan()
+{
+    const SlotGrid grid(utc(8, 0), utc(16, 0), RESOLUTION);
+    QCOMPARE(grid.range(), 32);
+    QCOMPARE(grid.slotStart(4), utc(9, 0));
+
+    int first = -1;
+    int count = -1;
+    // completely inside the timeframe
+    QVERIFY(grid.slotSpan(KCalendarCore::Period(utc(8, 30), utc(9, 10)), &first, &count));
+    QCOMPARE(first, 2);
+    QCOMPARE(count, 2);
+    // begins before the timeframe
+    QVERIFY(grid.slotSpan(KCalendarCore::Period(utc(7, 0), utc(8, 40)), &first, &count));
+    QCOMPARE(first, 0);
+    QCOMPARE(count, 2);
+    // ends after the timeframe
+    QVERIFY(grid.slotSpan(KCalendarCore::Period(utc(15, 50), utc(17, 0)), &first, &count));
+    QCOMPARE(first, 31);
+    QCOMPARE(count, 1);
+    // covers the timeframe
+    QVERIFY(grid.slotSpan(KCalendarCore::Period(utc(7, 0), utc(17, 0)), &first, &count));
+    QCOMPARE(first, 0);
+    QCOMPARE(count, 32);
+    // the same period in another time zone maps onto the same slots
+    const QTimeZone berlin("Europe/Berlin");
+    QVERIFY(grid.slotSpan(KCalendarCore::Period(utc(8, 30).toTimeZone(berlin), utc(9, 10).toTimeZone(berlin)), &first, &count));
+    QCOMPARE(first, 2);
+    QCOMPARE(count, 2);
+    // outside the timeframe
+    QVERIFY(!grid.slotSpan(KCalendarCore::Period(utc(6, 0), utc(7, 59)), &first, &count));
+}
+
+void SlotGridTest::testDaylightSavingTime()
+{
+    // On 2026-03-29 the clocks in Berlin go from 02:00 to 03:00
+    const QTimeZone berlin("Europe/Berlin");
+    const SlotGrid grid(QDateTime(QDate(2026, 3, 28), QTime(0, 0), berlin), QDateTime(QDate(2026, 3, 31), QTime(0, 0), berlin), 3600);
+    QCOMPARE(grid.range(), 71);
+
+    const qint64 before = QDateTime(QDate(2026, 3, 29), QTime(0, 59), Qt::UTC).toMSecsSinceEpoch();
+    QCOMPARE(grid.utcOffset(before), 3600);
+    QCOMPARE(grid.utcOffset(before + 60 * 1000), 7200);
+
+    const QVector<SlotGrid::Day> days = grid.days();
+    QCOMPARE(days.size(), 3);
+    QCOMPARE(days.at(0).date, QDate(2026, 3, 28));
+    QCOMPARE(days.at(0).first, 0);
+    QCOMPARE(days.at(0).last, 24);
+    QCOMPARE(days.at(1).date, QDate(2026, 3, 29));
+    QCOMPARE(days.at(1).first, 24);
+    QCOMPARE(days.at(1).last, 47);
+    QCOMPARE(days.at(2).date, QDate(2026, 3, 30));
+    QCOMPARE(days.at(2).first, 47);
+    QCOMPARE(days.at(2).last, 71);
+
+    // 09:00 is only eight hours after midnight on the short day
+    QCOMPARE(grid.firstSlotStartingAt(QDate(2026, 3, 29), QTime(9, 0)), 32);
+    QCOMPARE(grid.lastSlotEndingAt(QDate(2026, 3, 29), QTime(17, 0)), 40);
+    QCOMPARE(grid.firstSlotStartingAt(QDate(2026, 3, 30), QTime(9, 0)), 56);
+    QCOMPARE(grid.slotStart(32), QDateTime(QDate(2026, 3, 29), QTime(9, 0), berlin));
+}
+
+void SlotGridTest::testDays()
+{
+    // On 2026-10-25 the clocks in Berlin go from 03:00 back to 02:00
+    const QTimeZone berlin("Europe/Berlin");
+    const SlotGrid grid(QDateTime(QDate(2026, 10, 24), QTime(12, 0), berlin), QDateTime(QDate(2026, 10, 26), QTime(12, 0), berlin), RESOLUTION);
+    QCOMPARE(grid.range(), 49 * 4);
+
+    const QVector<SlotGrid::Day> days = grid.days();
+    QCOMPARE(days.size(), 3);
+    QCOMPARE(days.at(0).date, QDate(2026, 10, 24));
+    QCOMPARE(days.at(0).last - days.at(0).first, 12 * 4);
+    QCOMPARE(days.at(1).date, QDate(2026, 10, 25));
+    QCOMPARE(days.at(1).last - days.at(1).first, 25 * 4);
+    QCOMPARE(days.at(2).date, QDate(2026, 10, 26));
+    QCOMPARE(days.at(2).last, grid.range());
+
+    // an empty grid has no days
+    QVERIFY(SlotGrid().days().isEmpty());
+    QVERIFY(SlotGrid(utc(8, 0), utc(8, 0), RESOLUTION).days().isEmpty());
+}
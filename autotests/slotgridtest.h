@@ -0,0 +1,19 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class SlotGridTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSlotSpan();
+    void testDaylightSavingTime();
+    void testDays();
+};
+
@@ -12,11 +12,15 @@
 #include <CalendarSupport/FreeBusyItemModel>
 
 #include <KCalendarCore/Attendee>
+#include <KCalendarCore/FreeBusyPeriod>
 #include <KGantt/KGanttGraphicsView>
 
 #include <QAbstractItemModelTester>
+#include <QSignalSpy>
 #include <QStandardPaths>
 #include <QTest>
+
+#include <algorithm>
 QTEST_MAIN(FreeBusyGanttProxyModelTest)
 
 using namespace IncidenceEditorNG;
@@ -103,3 +107,209 @@ void FreeBusyGanttProxyModelTest::testModelValidity()
     delete ganttModel;
     delete modelTest;
 }
+
+void FreeBusyGanttProxyModelTest::testCachedData()
+{
+    CalendarSupport::FreeBusyItemModel fbModel;
+    FreeBusyGanttProxyModel ganttModel;
+    ganttModel.setSourceModel(&fbModel);
+
+    const QDateTime dt1(QDate(2010, 8, 24), QTime(7, 0, 0), Qt::UTC);
+    KCalendarCore::Attendee a1(QStringLiteral("fred"), QStringLiteral("fred@example.com"));
+    KCalendarCore::FreeBusy::Ptr fb1(new KCalendarCore::FreeBusy());
+    fb1->addPeriod(dt1, KCalendarCore::Duration(60 * 60));
+    CalendarSupport::FreeBusyItem::Ptr item1(new CalendarSupport::FreeBusyItem(a1, nullptr));
+    item1->setFreeBusy(fb1);
+    fbModel.addItem(item1);
+
+    QModelIndex child = ganttModel.index(0, 0, ganttModel.index(0, 0));
+    const auto period = ganttModel.mapToSource(child).data(CalendarSupport::FreeBusyItemModel::FreeBusyPeriodRole).value<KCalendarCore::FreeBusyPeriod>();
+    // repeated queries return the same data
+    for (int i = 0; i < 2; ++i) {
+        QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime(), dt1);
+        QCOMPARE(child.data(KGantt::EndTimeRole).toDateTime(), dt1.addSecs(60 * 60));
+        QCOMPARE(child.data(Qt::ToolTipRole).toString(), ganttModel.tooltipify(period));
+    }
+
+    // removing an attendee shifts the cached rows of the following ones
+    const QDateTime dt2(QDate(2010, 8, 25), QTime(9, 0, 0), Qt::UTC);
+    KCalendarCore::Attendee a2(QStringLiteral("joe"), QStringLiteral("joe@example.com"));
+    KCalendarCore::FreeBusy::Ptr fb2(new KCalendarCore::FreeBusy());
+    fb2->addPeriod(dt2, KCalendarCore::Duration(2 * 60 * 60));
+    CalendarSupport::FreeBusyItem::Ptr item2(new CalendarSupport::FreeBusyItem(a2, nullptr));
+    item2->setFreeBusy(fb2);
+    fbModel.removeAttendee(a1);
+    fbModel.addItem(item2);
+    fbModel.addItem(item1);
+
+    child = ganttModel.index(0, 0, ganttModel.index(0, 0));
+    QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime(), dt2);
+    QCOMPARE(child.data(KGantt::EndTimeRole).toDateTime(), dt2.addSecs(2 * 60 * 60));
+    child = ganttModel.index(0, 0, ganttModel.index(1, 0));
+    QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime(), dt1);
+
+    // a reset drops everything
+    fbModel.clear();
+    fbModel.addItem(item2);
+    child = ganttModel.index(0, 0, ganttModel.index(0, 0));
+    QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime(), dt2);
+}
+
+void FreeBusyGanttProxyModelTest::testVisibleWindow()
+{
+    CalendarSupport::FreeBusyItemModel fbModel;
+    FreeBusyGanttProxyModel ganttModel;
+    ganttModel.setSourceModel(&fbModel);
+    QAbstractItemModelTester modelTest(&ganttModel);
+
+    const QDateTime dt1(QDate(2010, 8, 24), QTime(7, 0, 0), Qt::UTC);
+    const QDateTime dt2(QDate(2010, 8, 26), QTime(7, 0, 0), Qt::UTC);
+    const QStringList names = {QStringLiteral("fred"), QStringLiteral("joe"), QStringLiteral("jane")};
+    for (const QString &name : names) {
+        KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy());
+        fb->addPeriod(dt1, KCalendarCore::Duration(60 * 60));
+        fb->addPeriod(dt2, KCalendarCore::Duration(60 * 60));
+        CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(KCalendarCore::Attendee(name, name + QStringLiteral("@example.com")), nullptr));
+        item->setFreeBusy(fb);
+        fbModel.addItem(item);
+    }
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(0, 0)), 2);
+
+    // only the first period of the first two attendees is visible
+    ganttModel.setVisibleWindow(dt1.addDays(-1), dt1.addDays(1), 0, 1);
+    QCOMPARE(ganttModel.rowCount(), 3);
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(0, 0)), 1);
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(1, 0)), 1);
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(2, 0)), 0);
+    QCOMPARE(ganttModel.index(0, 0, ganttModel.index(1, 0)).data(KGantt::StartTimeRole).toDateTime(), dt1);
+
+    // a period touching the window is not visible
+    ganttModel.setVisibleWindow(dt1.addSecs(60 * 60), dt2, 0, 2);
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(2, 0)), 0);
+
+    // scrolling on
+    ganttModel.setVisibleWindow(dt2.addDays(-1), dt2.addDays(1), 1, 2);
+    QCOMPARE(ganttModel.rowCount(ganttModel.index(0, 0)), 0);
+    QCOMPARE(ganttModel.index(0, 0, ganttModel.index(2, 0)).data(KGantt::StartTimeRole).toDateTime(), dt2);
+
+    ganttModel.setVisibleWindow(QDateTime(), QDateTime(), 0, 0);
+    for (int row = 0; row < names.size(); ++row) {
+        QCOMPARE(ganttModel.rowCount(ganttModel.index(row, 0)), 2);
+    }
+}
+
+void FreeBusyGanttProxyModelTest::testMergedSpans()
+{
+    CalendarSupport::FreeBusyItemModel fbModel;
+    FreeBusyGanttProxyModel ganttModel;
+    ganttModel.setSourceModel(&fbModel);
+    QAbstractItemModelTester modelTest(&ganttModel);
+
+    // 7:00-8:00, 8:00-8:30 and 8:31-9:00 are less than two minutes apart, 12:00-13:00 is not
+    const QDateTime dt(QDate(2010, 8, 24), QTime(7, 0, 0), Qt::UTC);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy());
+    fb->addPeriod(dt.addSecs(5 * 60 * 60), KCalendarCore::Duration(60 * 60));
+    fb->addPeriod(dt.addSecs(60 * 60), KCalendarCore::Duration(30 * 60));
+    fb->addPeriod(dt, KCalendarCore::Duration(60 * 60));
+    fb->addPeriod(dt.addSecs(91 * 60), KCalendarCore::Duration(29 * 60));
+    CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(KCalendarCore::Attendee(QStringLiteral("fred"), QStringLiteral("fred@example.com")), nullptr));
+    item->setFreeBusy(fb);
+    fbModel.addItem(item);
+
+    const QModelIndex parent = ganttModel.index(0, 0);
+    QCOMPARE(ganttModel.rowCount(parent), 4);
+
+    ganttModel.setMergeDistance(2 * 60);
+    QCOMPARE(ganttModel.rowCount(parent), 2);
+    QVector<QPair<QDateTime, QDateTime>> spans;
+    for (int row = 0; row < 2; ++row) {
+        const QModelIndex child = ganttModel.index(row, 0, parent);
+        spans.append(qMakePair(child.data(KGantt::StartTimeRole).toDateTime(), child.data(KGantt::EndTimeRole).toDateTime()));
+    }
+    std::sort(spans.begin(), spans.end());
+    QCOMPARE(spans.at(0), qMakePair(dt, dt.addSecs(2 * 60 * 60)));
+    QCOMPARE(spans.at(1), qMakePair(dt.addSecs(5 * 60 * 60), dt.addSecs(6 * 60 * 60)));
+
+    // touching periods are merged with any distance
+    ganttModel.setMergeDistance(1);
+    QCOMPARE(ganttModel.rowCount(parent), 3);
+
+    ganttModel.setMergeDistance(0);
+    QCOMPARE(ganttModel.rowCount(parent), 4);
+    for (int row = 0; row < 4; ++row) {
+        const QModelIndex child = ganttModel.index(row, 0, parent);
+        QVERIFY(child.data(KGantt::StartTimeRole).toDateTime() < child.data(KGantt::EndTimeRole).toDateTime());
+        QVERIFY(child.data(KGantt::EndTimeRole).toDateTime().secsTo(child.data(KGantt::StartTimeRole).toDateTime()) >= -60 * 60);
+    }
+}
+
+void FreeBusyGanttProxyModelTest::testMergedSpansChanged()
+{
+    CalendarSupport::FreeBusyItemModel fbModel;
+    FreeBusyGanttProxyModel ganttModel;
+    ganttModel.setSourceModel(&fbModel);
+    QAbstractItemModelTester modelTest(&ganttModel);
+
+    const QDateTime dt(QDate(2010, 8, 24), QTime(7, 0, 0), Qt::UTC);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy());
+    fb->addPeriod(dt, KCalendarCore::Duration(60 * 60));
+    fb->addPeriod(dt.addSecs(5 * 60 * 60), KCalendarCore::Duration(60 * 60));
+    CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(KCalendarCore::Attendee(QStringLiteral("fred"), QStringLiteral("fred@example.com")), nullptr));
+    item->setFreeBusy(fb);
+    fbModel.addItem(item);
+
+    const QModelIndex parent = ganttModel.index(0, 0);
+    ganttModel.setMergeDistance(2 * 60);
+    QCOMPARE(ganttModel.rowCount(parent), 2);
+
+    // a new period bridging the gap merges the other two into one span
+    KCalendarCore::FreeBusyPeriod::List periods = fb->fullBusyPeriods();
+    periods.append(KCalendarCore::FreeBusyPeriod(dt.addSecs(60 * 60), dt.addSecs(5 * 60 * 60)));
+    QSignalSpy dataChangedSpy(&ganttModel, &QAbstractItemModel::dataChanged);
+    fbModel.setFreeBusyPeriods(fbModel.index(0, 0), periods);
+    QCOMPARE(ganttModel.rowCount(parent), 1);
+    const QModelIndex span = ganttModel.index(0, 0, parent);
+    QCOMPARE(span.data(KGantt::StartTimeRole).toDateTime(), dt);
+    QCOMPARE(span.data(KGantt::EndTimeRole).toDateTime(), dt.addSecs(6 * 60 * 60));
+    QVERIFY(!dataChangedSpy.isEmpty());
+
+    // and splits again once it's gone
+    periods.removeLast();
+    fbModel.setFreeBusyPeriods(fbModel.index(0, 0), periods);
+    QCOMPARE(ganttModel.rowCount(parent), 2);
+    for (int row = 0; row < 2; ++row) {
+        const QModelIndex child = ganttModel.index(row, 0, parent);
+        QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime().secsTo(child.data(KGantt::EndTimeRole).toDateTime()), 60 * 60);
+    }
+}
+
+void FreeBusyGanttProxyModelTest::testOverlappingPeriods()
+{
+    CalendarSupport::FreeBusyItemModel fbModel;
+    FreeBusyGanttProxyModel ganttModel;
+    ganttModel.setSourceModel(&fbModel);
+    QAbstractItemModelTester modelTest(&ganttModel);
+
+    const QDateTime dt(QDate(2010, 8, 24), QTime(7, 0, 0), Qt::UTC);
+    KCalendarCore::FreeBusy::Ptr fb(new KCalendarCore::FreeBusy());
+    fb->addPeriod(dt, KCalendarCore::Duration(2 * 60 * 60));
+    fb->addPeriod(dt.addSecs(60 * 60), KCalendarCore::Duration(2 * 60 * 60));
+    CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(KCalendarCore::Attendee(QStringLiteral("fred"), QStringLiteral("fred@example.com")), nullptr));
+    item->setFreeBusy(fb);
+    fbModel.addItem(item);
+
+    // without merging, overlapping periods are exposed on their own as well
+    const QModelIndex parent = ganttModel.index(0, 0);
+    QCOMPARE(ganttModel.rowCount(parent), 2);
+    for (int row = 0; row < 2; ++row) {
+        const QModelIndex child = ganttModel.index(row, 0, parent);
+        QCOMPARE(child.data(KGantt::StartTimeRole).toDateTime().secsTo(child.data(KGantt::EndTimeRole).toDateTime()), 2 * 60 * 60);
+    }
+
+    ganttModel.setMergeDistance(60);
+    QCOMPARE(ganttModel.rowCount(parent), 1);
+    QCOMPARE(ganttModel.index(0, 0, parent).data(KGantt::EndTimeRole).toDateTime(), dt.addSecs(3 * 60 * 60));
+
+    ganttModel.setMergeDistance(0);
+    QCOMPARE(ganttModel.rowCount(parent), 2);
+}
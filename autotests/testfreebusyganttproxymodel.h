@@ -14,5 +14,10 @@ class FreeBusyGanttProxyModelTest : public QObject
 private Q_SLOTS:
     void initTestCase();
     void testModelValidity();
+    void testCachedData();
+    void testVisibleWindow();
+    void testMergedSpans();
+    void testMergedSpansChanged();
+    void testOverlappingPeriods();
 };
 
@@ -0,0 +1,410 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+/*
+  Measures the scheduling hot path of ConflictResolver on synthesized
+  free/busy data, for a range of attendee counts, timeframes and slot
+  resolutions.
+
+  Every scenario is repeated until it ran for at least --min-time
+  milliseconds, and reported with its mean and fastest iteration and the
+  peak memory use while it ran, as a table, CSV or JSON.
+*/
+
+#include "conflictresolver.h"
+
+#include <CalendarSupport/FreeBusyItem>
+#include <KCalendarCore/FreeBusy>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <functional>
+#include <memory>
+
+using namespace IncidenceEditorNG;
+
+namespace
+{
+struct Scenario {
+    QString operation;
+    int attendees = 0;
+    int windowDays = 0;
+    int resolutionMinutes = 0;
+
+    QString name() const
+    {
+        return QStringLiteral("%1/attendees:%2/window:%3d/resolution:%4m").arg(operation).arg(attendees).arg(windowDays).arg(resolutionMinutes);
+    }
+};
+
+struct Measurement {
+    Scenario scenario;
+    int iterations = 0;
+    double meanMSecs = 0;
+    double minMSecs = 0;
+    qint64 peakMemoryKiB = -1; //!< -1 if unknown
+};
+
+/**
+  Runs one iteration. Returns the nanoseconds spent in the measured part.
+*/
+using Iteration = std::function<qint64()>;
+
+QDateTime windowBegin()
+{
+    // A fixed Monday in the future, so findFreeSlot() does not skip anything
+    return QDateTime(QDate(2100, 3, 1), QTime(0, 0), Qt::UTC);
+}
+
+/**
+  Returns free/busy data of a typical attendee: a few meetings of 30 to 120
+  minutes between 8:00 and 18:00 on every workday of the window. The data
+  only depends on @p seed, so runs are comparable.
+*/
+KCalendarCore::FreeBusy::Ptr makeFreeBusy(quint32 seed, int windowDays)
+{
+    QRandomGenerator random(seed);
+    const QDateTime begin = windowBegin();
+    const QDateTime end = begin.addDays(windowDays);
+    KCalendarCore::Period::List busyPeriods;
+    for (int day = 0; day < windowDays; ++day) {
+        const QDateTime dayBegin = begin.addDays(day);
+        if (dayBegin.date().dayOfWeek() > 5) {
+            continue;
+        }
+        const int meetings = random.bounded(1, 6);
+        for (int i = 0; i < meetings; ++i) {
+            const QDateTime start = dayBegin.addSecs(8 * 3600 + random.bounded(40) * 15 * 60);
+            busyPeriods << KCalendarCore::Period(start, start.addSecs(random.bounded(2, 9) * 15 * 60));
+        }
+    }
+    KCalendarCore::FreeBusy::Ptr freeBusy(new KCalendarCore::FreeBusy(busyPeriods));
+    freeBusy->setDtStart(begin);
+    freeBusy->setDtEnd(end);
+    return freeBusy;
+}
+
+class Fixture
+{
+public:
+    explicit Fixture(const Scenario &scenario)
+        : mScenario(scenario)
+    {
+        mFreeBusy.reserve(scenario.attendees);
+        for (int i = 0; i < scenario.attendees; ++i) {
+            mFreeBusy << makeFreeBusy(i + 1, scenario.windowDays);
+        }
+    }
+
+    std::unique_ptr<ConflictResolver> makeResolver() const
+    {
+        std::unique_ptr<ConflictResolver> resolver(new ConflictResolver(nullptr));
+        for (int i = 0; i < mFreeBusy.size(); ++i) {
+            const KCalendarCore::Attendee attendee(QStringLiteral("attendee %1").arg(i),
+                                                   QStringLiteral("attendee%1@example.org").arg(i),
+                                                   false,
+                                                   KCalendarCore::Attendee::Accepted,
+                                                   KCalendarCore::Attendee::ReqParticipant);
+            CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(attendee, nullptr));
+            item->setFreeBusy(mFreeBusy.at(i));
+            resolver->insertAttendee(item);
+        }
+        resolver->setResolution(mScenario.resolutionMinutes * 60);
+        resolver->setEarliestDateTime(windowBegin());
+        resolver->setLatestDateTime(windowBegin().addDays(mScenario.windowDays));
+        return resolver;
+    }
+
+private:
+    const Scenario mScenario;
+    QVector<KCalendarCore::FreeBusy::Ptr> mFreeBusy;
+};
+
+#ifdef Q_OS_LINUX
+void resetPeakMemory()
+{
+    // Resets VmHWM, see proc(5)
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+}
+
+qint64 peakMemoryKiB()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    while (!status.atEnd()) {
+        const QByteArray line = status.readLine();
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+    return -1;
+}
+#else
+void resetPeakMemory()
+{
+}
+
+qint64 peakMemoryKiB()
+{
+    return -1;
+}
+#endif
+
+Iteration makeIteration(const Scenario &scenario, const Fixture &fixture, std::unique_ptr<ConflictResolver> &resolver)
+{
+    const QString &operation = scenario.operation;
+    if (operation == QLatin1String("findAllFreeSlots/matrix") || operation == QLatin1String("findAllFreeSlots/sweep")) {
+        // cold: a new resolver every time, so nothing is cached
+        const auto algorithm = operation.endsWith(QLatin1String("matrix")) ? ConflictResolver::SlotMatrix : ConflictResolver::IntervalSweep;
+        return [&fixture, &resolver, algorithm]() {
+            resolver = fixture.makeResolver();
+            resolver->setFreeSlotAlgorithm(algorithm);
+            QElapsedTimer timer;
+            timer.start();
+            resolver->findAllFreeSlots();
+            return timer.nsecsElapsed();
+        };
+    }
+
+    resolver = fixture.makeResolver();
+    ConflictResolver *warmResolver = resolver.get();
+    if (operation == QLatin1String("findAllFreeSlots/matrix-warm")) {
+        warmResolver->findAllFreeSlots();
+        return [warmResolver]() {
+            QElapsedTimer timer;
+            timer.start();
+            warmResolver->findAllFreeSlots();
+            return timer.nsecsElapsed();
+        };
+    }
+    if (operation == QLatin1String("conflicts")) {
+        // counts the conflicts of the timeframe, as on every change of the event times
+        return [warmResolver]() {
+            QElapsedTimer timer;
+            timer.start();
+            warmResolver->freebusyDataChanged();
+            return timer.nsecsElapsed();
+        };
+    }
+    if (operation == QLatin1String("findFreeSlot")) {
+        const KCalendarCore::Period request(windowBegin().addSecs(9 * 3600), windowBegin().addSecs(10 * 3600));
+        return [warmResolver, request]() {
+            QElapsedTimer timer;
+            timer.start();
+            const bool found = warmResolver->findFreeSlot(request);
+            Q_UNUSED(found)
+            return timer.nsecsElapsed();
+        };
+    }
+    if (operation == QLatin1String("rankedFreeSlots")) {
+        const KCalendarCore::Period request(windowBegin().addSecs(9 * 3600), windowBegin().addSecs(10 * 3600));
+        return [warmResolver, request]() {
+            QElapsedTimer timer;
+            timer.start();
+            const auto candidates = warmResolver->rankedFreeSlots(request, 5);
+            Q_UNUSED(candidates)
+            return timer.nsecsElapsed();
+        };
+    }
+    Q_UNREACHABLE();
+    return {};
+}
+
+QVector<Scenario> allScenarios()
+{
+    QVector<Scenario> scenarios;
+    const QStringList slotOperations = {QStringLiteral("findAllFreeSlots/matrix"),
+                                        QStringLiteral("findAllFreeSlots/matrix-warm"),
+                                        QStringLiteral("findAllFreeSlots/sweep")};
+    // These do not use the slot grid, so the resolution does not matter
+    const QStringList intervalOperations = {QStringLiteral("conflicts"), QStringLiteral("findFreeSlot"), QStringLiteral("rankedFreeSlots")};
+
+    for (int attendees : {10, 100, 1000}) {
+        for (int windowDays : {1, 7, 30, 365}) {
+            for (int resolutionMinutes : {1, 5, 15}) {
+                for (const QString &operation : slotOperations) {
+                    scenarios.append({operation, attendees, windowDays, resolutionMinutes});
+                }
+            }
+            for (const QString &operation : intervalOperations) {
+                scenarios.append({operation, attendees, windowDays, 15});
+            }
+        }
+    }
+    return scenarios;
+}
+
+Measurement run(const Scenario &scenario, qint64 minTimeMSecs)
+{
+    const Fixture fixture(scenario);
+    std::unique_ptr<ConflictResolver> resolver;
+    const Iteration iteration = makeIteration(scenario, fixture, resolver);
+
+    resetPeakMemory();
+    Measurement measurement;
+    measurement.scenario = scenario;
+    qint64 totalNSecs = 0;
+    qint64 minNSecs = -1;
+    do {
+        const qint64 nsecs = iteration();
+        totalNSecs += nsecs;
+        minNSecs = minNSecs < 0 ? nsecs : qMin(minNSecs, nsecs);
+        ++measurement.iterations;
+    } while (totalNSecs < minTimeMSecs * 1000000 && measurement.iterations < 10000);
+    measurement.peakMemoryKiB = peakMemoryKiB();
+    measurement.meanMSecs = totalNSecs / 1e6 / measurement.iterations;
+    measurement.minMSecs = minNSecs / 1e6;
+    return measurement;
+}
+
+QByteArray toJson(const QVector<Measurement> &measurements)
+{
+    QJsonObject context;
+    context.insert(QStringLiteral("date"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    context.insert(QStringLiteral("qt_version"), QString::fromLatin1(qVersion()));
+#ifdef QT_NO_DEBUG
+    context.insert(QStringLiteral("build_type"), QStringLiteral("release"));
+#else
+    context.insert(QStringLiteral("build_type"), QStringLiteral("debug"));
+#endif
+
+    QJsonArray benchmarks;
+    for (const Measurement &measurement : measurements) {
+        QJsonObject benchmark;
+        benchmark.insert(QStringLiteral("name"), measurement.scenario.name());
+        benchmark.insert(QStringLiteral("operation"), measurement.scenario.operation);
+        benchmark.insert(QStringLiteral("attendees"), measurement.scenario.attendees);
+        benchmark.insert(QStringLiteral("window_days"), measurement.scenario.windowDays);
+        benchmark.insert(QStringLiteral("resolution_minutes"), measurement.scenario.resolutionMinutes);
+        benchmark.insert(QStringLiteral("iterations"), measurement.iterations);
+        benchmark.insert(QStringLiteral("real_time"), measurement.meanMSecs);
+        benchmark.insert(QStringLiteral("min_time"), measurement.minMSecs);
+        benchmark.insert(QStringLiteral("time_unit"), QStringLiteral("ms"));
+        benchmark.insert(QStringLiteral("peak_memory_kib"), measurement.peakMemoryKiB);
+        benchmarks.append(benchmark);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("context"), context);
+    root.insert(QStringLiteral("benchmarks"), benchmarks);
+    return QJsonDocument(root).toJson();
+}
+
+void writeCsvHeader(QTextStream &out)
+{
+    out << "name,iterations,real_time_ms,min_time_ms,peak_memory_kib\n";
+}
+
+void writeCsv(QTextStream &out, const Measurement &measurement)
+{
+    out << measurement.scenario.name() << ',' << measurement.iterations << ',' << measurement.meanMSecs << ',' << measurement.minMSecs << ','
+        << measurement.peakMemoryKiB << '\n';
+}
+
+void writeConsole(QTextStream &out, const Measurement &measurement)
+{
+    out << qSetFieldWidth(72) << Qt::left << measurement.scenario.name() << qSetFieldWidth(12) << Qt::right << measurement.meanMSecs
+        << measurement.minMSecs << measurement.iterations << measurement.peakMemoryKiB << qSetFieldWidth(0) << '\n';
+}
+}
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures the free slot search of the incidence editor."));
+    parser.addHelpOption();
+    const QCommandLineOption formatOption(QStringLiteral("format"), QStringLiteral("Output format: console, csv or json."), QStringLiteral("format"), QStringLiteral("console"));
+    const QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the results to <file> instead of stdout."), QStringLiteral("file"));
+    const QCommandLineOption filterOption(QStringLiteral("filter"), QStringLiteral("Only run the scenarios whose name matches <regexp>."), QStringLiteral("regexp"));
+    const QCommandLineOption minTimeOption(QStringLiteral("min-time"),
+                                           QStringLiteral("Repeat each scenario for at least <msecs> milliseconds."),
+                                           QStringLiteral("msecs"),
+                                           QStringLiteral("500"));
+    const QCommandLineOption listOption(QStringLiteral("list"), QStringLiteral("List the scenarios and exit."));
+    parser.addOptions({formatOption, outputOption, filterOption, minTimeOption, listOption});
+    parser.process(app);
+
+    const QString format = parser.value(formatOption);
+    if (format != QLatin1String("console") && format != QLatin1String("csv") && format != QLatin1String("json")) {
+        QTextStream(stderr) << "Unknown format " << format << '\n';
+        return 1;
+    }
+
+    const QRegularExpression filter(parser.value(filterOption));
+    if (!filter.isValid()) {
+        QTextStream(stderr) << "Invalid filter: " << filter.errorString() << '\n';
+        return 1;
+    }
+    QVector<Scenario> scenarios;
+    const QVector<Scenario> all = allScenarios();
+    for (const Scenario &scenario : all) {
+        if (filter.match(scenario.name()).hasMatch()) {
+            scenarios.append(scenario);
+        }
+    }
+
+    QFile outputFile;
+    if (parser.isSet(outputOption)) {
+        outputFile.setFileName(parser.value(outputOption));
+        if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write " << outputFile.fileName() << ": " << outputFile.errorString() << '\n';
+            return 1;
+        }
+    } else {
+        outputFile.open(stdout, QIODevice::WriteOnly);
+    }
+    QTextStream out(&outputFile);
+
+    if (parser.isSet(listOption)) {
+        for (const Scenario &scenario : qAsConst(scenarios)) {
+            out << scenario.name() << '\n';
+        }
+        return 0;
+    }
+
+    const qint64 minTimeMSecs = parser.value(minTimeOption).toLongLong();
+    if (format == QLatin1String("csv")) {
+        writeCsvHeader(out);
+    } else if (format == QLatin1String("console")) {
+        out << qSetFieldWidth(72) << Qt::left << "scenario" << qSetFieldWidth(12) << Qt::right << "mean ms"
+            << "min ms"
+            << "iterations"
+            << "peak KiB" << qSetFieldWidth(0) << '\n';
+    }
+
+    // Results are written as they come in, except for JSON which needs all of them
+    QVector<Measurement> measurements;
+    for (const Scenario &scenario : qAsConst(scenarios)) {
+        const Measurement measurement = run(scenario, minTimeMSecs);
+        if (format == QLatin1String("csv")) {
+            writeCsv(out, measurement);
+        } else if (format == QLatin1String("console")) {
+            writeConsole(out, measurement);
+        }
+        out.flush();
+        measurements.append(measurement);
+    }
+    if (format == QLatin1String("json")) {
+        out << toJson(measurements);
+    }
+    return 0;
+}
@@ -10,8 +10,15 @@
 
 #include <KLocalizedString>
 
+#include <algorithm>
+
 using namespace IncidenceEditorNG;
 
+static QString normalizedEmail(const QString &email)
+{
+    return email.trimmed().toLower();
+}
+
 AttendeeTableModel::AttendeeTableModel(QObject *parent)
     : QAbstractTableModel(parent)
 {
@@ -98,6 +105,7 @@ bool AttendeeTableModel::setData(const QModelIndex &index, const QVariant &value
     QString email, name;
     if (index.isValid() && role == Qt::EditRole) {
         KCalendarCore::Attendee &attendee = mAttendeeList[index.row()];// clazy:exclude=detaching-member
+        const QString oldUid = attendee.uid();
         switch (index.column()) {
         case Role:
             attendee.setRole(static_cast<KCalendarCore::Attendee::Role>(value.toInt()));
@@ -112,6 +120,20 @@ bool AttendeeTableModel::setData(const QModelIndex &index, const QVariant &value
                 }
             }
             KEmailAddress::extractEmailAddressAndName(value.toString(), email, name);
+            if (mIndexesValid && normalizedEmail(email) != normalizedEmail(attendee.email())) {
+                // move the row to its new email in the index
+                auto it = mEmailIndex.find(normalizedEmail(attendee.email()));
+                if (it != mEmailIndex.end()) {
+                    it->removeOne(index.row());
+                    if (it->isEmpty()) {
+                        mEmailIndex.erase(it);
+                    }
+                }
+                if (!email.isEmpty()) {
+                    QVector<int> &rows = mEmailIndex[normalizedEmail(email)];
+                    rows.insert(std::lower_bound(rows.begin(), rows.end(), index.row()), index.row());
+                }
+            }
             attendee.setName(name);
             attendee.setEmail(email);
 
@@ -132,6 +154,7 @@ bool AttendeeTableModel::setData(const QModelIndex &index, const QVariant &value
         default:
             return false;
         }
+        reindexUid(index.row(), oldUid);
         Q_EMIT dataChanged(index, index);
         return true;
     }
@@ -172,11 +195,15 @@ bool AttendeeTableModel::insertRows(int position, int rows, const QModelIndex &p
 {
     beginInsertRows(parent, position, position + rows - 1);
 
+    if (position < mAttendeeList.size()) {
+        invalidateIndexes();
+    }
     for (int row = 0; row < rows; ++row) {
         KCalendarCore::Attendee attendee(QLatin1String(""), QLatin1String(""));
         mAttendeeList.insert(position, attendee);
         mAttendeeAvailable.insert(mAttendeeAvailable.begin() + position, AvailableStatus{});
     }
+    indexRows(position);
 
     endInsertRows();
     return true;
@@ -186,6 +213,11 @@ bool AttendeeTableModel::removeRows(int position, int rows, const QModelIndex &p
 {
     beginRemoveRows(parent, position, position + rows - 1);
 
+    if (position + rows < mAttendeeList.size()) {
+        invalidateIndexes();
+    } else {
+        unindexRows(position);
+    }
     for (int row = 0; row < rows; ++row) {
         mAttendeeAvailable.erase(mAttendeeAvailable.begin() + position);
         mAttendeeList.remove(position);
@@ -197,9 +229,24 @@ bool AttendeeTableModel::removeRows(int position, int rows, const QModelIndex &p
 
 bool AttendeeTableModel::insertAttendee(int position, const KCalendarCore::Attendee &attendee)
 {
-    beginInsertRows(QModelIndex(), position, position);
-    mAttendeeList.insert(position, attendee);
-    mAttendeeAvailable.insert(mAttendeeAvailable.begin() + position, AvailableStatus{});
+    return insertAttendees(position, {attendee});
+}
+
+bool AttendeeTableModel::insertAttendees(int position, const KCalendarCore::Attendee::List &attendees)
+{
+    if (attendees.isEmpty()) {
+        return false;
+    }
+
+    beginInsertRows(QModelIndex(), position, position + attendees.size() - 1);
+    if (position == mAttendeeList.size()) {
+        mAttendeeList += attendees;
+    } else {
+        invalidateIndexes();
+        mAttendeeList = mAttendeeList.mid(0, position) + attendees + mAttendeeList.mid(position);
+    }
+    mAttendeeAvailable.insert(mAttendeeAvailable.begin() + position, attendees.size(), AvailableStatus{});
+    indexRows(position);
     endInsertRows();
 
     addEmptyAttendee();
@@ -214,6 +261,7 @@ void AttendeeTableModel::setAttendees(const KCalendarCore::Attendee::List &atten
     mAttendeeList = attendees;
     mAttendeeAvailable.clear();
     mAttendeeAvailable.resize(attendees.size());
+    invalidateIndexes();
 
     addEmptyAttendee();
 
@@ -225,6 +273,154 @@ KCalendarCore::Attendee::List AttendeeTableModel::attendees() const
     return mAttendeeList;
 }
 
+void AttendeeTableModel::setAvailable(const QMap<int, AvailableStatus> &available)
+{
+    int first = -1;
+    int last = -1;
+    for (auto it = available.cbegin(), end = available.cend(); it != end; ++it) {
+        if (it.key() < 0 || it.key() >= static_cast<int>(mAttendeeAvailable.size()) || mAttendeeAvailable[it.key()] == it.value()) {
+            continue;
+        }
+        mAttendeeAvailable[it.key()] = it.value();
+        if (first < 0) {
+            first = it.key();
+        }
+        last = it.key();
+    }
+    if (first >= 0) {
+        Q_EMIT dataChanged(index(first, Available), index(last, Available));
+    }
+}
+
+int AttendeeTableModel::rowOfUid(const QString &uid) const
+{
+    ensureIndexes();
+    const auto it = mUidIndex.constFind(uid);
+    if (it != mUidIndex.constEnd()) {
+        const int row = it.value();
+        if (row < mAttendeeList.size() && mAttendeeList.at(row).uid() == uid) {
+            return row;
+        }
+        // Made up uids change when the attendee is detached, don't trust a
+        // stale entry and look at all rows.
+        mUidIndex.remove(uid);
+        for (int i = 0; i < mAttendeeList.size(); ++i) {
+            if (mAttendeeList.at(i).uid() == uid) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    // Go on where the last lookup stopped
+    while (mUidIndexedRows < mAttendeeList.size()) {
+        const int row = mUidIndexedRows++;
+        const QString rowUid = mAttendeeList.at(row).uid();
+        if (!mUidIndex.contains(rowUid)) {
+            mUidIndex.insert(rowUid, row);
+        }
+        if (rowUid == uid) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QVector<int> AttendeeTableModel::rowsOfEmail(const QString &email) const
+{
+    ensureIndexes();
+    return mEmailIndex.value(normalizedEmail(email));
+}
+
+int AttendeeTableModel::rowOfAttendee(const KCalendarCore::Attendee &attendee) const
+{
+    const QVector<int> rows = rowsOfEmail(attendee.email());
+    for (const int row : rows) {
+        if (mAttendeeList.at(row) == attendee) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void AttendeeTableModel::reindexUid(int row, const QString &oldUid)
+{
+    if (!mIndexesValid) {
+        return;
+    }
+    // Editing may detach the attendee, which changes a made up uid
+    const QString uid = mAttendeeList.at(row).uid();
+    if (uid == oldUid) {
+        return;
+    }
+    if (mUidIndex.value(oldUid, -1) == row) {
+        mUidIndex.remove(oldUid);
+    }
+    if (row < mUidIndexedRows && !mUidIndex.contains(uid)) {
+        mUidIndex.insert(uid, row);
+    }
+}
+
+void AttendeeTableModel::unindexRows(int first) const
+{
+    if (!mIndexesValid) {
+        return;
+    }
+    // The rows from first on are the last ones of each email
+    for (int row = first; row < mAttendeeList.size(); ++row) {
+        const QString &email = mAttendeeList.at(row).email();
+        if (email.isEmpty()) {
+            continue;
+        }
+        auto it = mEmailIndex.find(normalizedEmail(email));
+        if (it == mEmailIndex.end()) {
+            continue;
+        }
+        while (!it->isEmpty() && it->constLast() >= first) {
+            it->removeLast();
+        }
+        if (it->isEmpty()) {
+            mEmailIndex.erase(it);
+        }
+    }
+
+    for (int row = first; row < mUidIndexedRows; ++row) {
+        const QString uid = mAttendeeList.at(row).uid();
+        if (mUidIndex.value(uid, -1) == row) {
+            mUidIndex.remove(uid);
+        }
+    }
+    mUidIndexedRows = qMin(mUidIndexedRows, first);
+}
+
+void AttendeeTableModel::indexRows(int first) const
+{
+    if (!mIndexesValid) {
+        return;
+    }
+    for (int row = first; row < mAttendeeList.size(); ++row) {
+        const QString &email = mAttendeeList.at(row).email();
+        if (!email.isEmpty()) {
+            mEmailIndex[normalizedEmail(email)].append(row);
+        }
+    }
+}
+
+void AttendeeTableModel::invalidateIndexes()
+{
+    mIndexesValid = false;
+    mEmailIndex.clear();
+    mUidIndex.clear();
+    mUidIndexedRows = 0;
+}
+
+void AttendeeTableModel::ensureIndexes() const
+{
+    if (!mIndexesValid) {
+        mIndexesValid = true;
+        indexRows(0);
+    }
+}
+
 void AttendeeTableModel::addEmptyAttendee()
 {
     if (mKeepEmpty) {
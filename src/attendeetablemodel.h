@@ -6,15 +6,19 @@
 
 #pragma once
 
+#include "incidenceeditor_private_export.h"
+
 #include <KCalendarCore/Attendee>
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QMap>
 #include <QModelIndex>
 #include <QSortFilterProxyModel>
 
 namespace IncidenceEditorNG
 {
-class AttendeeTableModel : public QAbstractTableModel
+class INCIDENCEEDITOR_TESTS_EXPORT AttendeeTableModel : public QAbstractTableModel
 {
     Q_OBJECT
 
@@ -40,9 +44,37 @@ public:
 
     bool insertAttendee(int position, const KCalendarCore::Attendee &attendee);
 
+    /**
+     * Inserts @p attendees at @p position as one range of rows, so that
+     * views, proxies and listeners only have to catch up once.
+     */
+    bool insertAttendees(int position, const KCalendarCore::Attendee::List &attendees);
+
     void setAttendees(const KCalendarCore::Attendee::List &resources);
     Q_REQUIRED_RESULT KCalendarCore::Attendee::List attendees() const;
 
+    /**
+     * Sets the Available column of the rows in @p available, emitting a
+     * single dataChanged() covering the rows which changed.
+     */
+    void setAvailable(const QMap<int, AvailableStatus> &available);
+
+    /**
+     * Returns the row of the first attendee with the uid @p uid, or -1.
+     */
+    Q_REQUIRED_RESULT int rowOfUid(const QString &uid) const;
+
+    /**
+     * Returns the rows of the attendees with the email address @p email,
+     * ignoring case and surrounding whitespace, in ascending order.
+     */
+    Q_REQUIRED_RESULT QVector<int> rowsOfEmail(const QString &email) const;
+
+    /**
+     * Returns the row of the first attendee equal to @p attendee, or -1.
+     */
+    Q_REQUIRED_RESULT int rowOfAttendee(const KCalendarCore::Attendee &attendee) const;
+
     void setKeepEmpty(bool keepEmpty);
     Q_REQUIRED_RESULT bool keepEmpty() const;
 
@@ -52,8 +84,38 @@ public:
 private:
     void addEmptyAttendee();
 
+    /**
+     * Moves @p row from @p oldUid to the current uid of its attendee in the
+     * uid index.
+     */
+    void reindexUid(int row, const QString &oldUid);
+
+    /**
+     * Drop the rows from @p first on from the indexes, and add them again
+     * once they are in place. Both only touch the rows from @p first on, so
+     * they are only used for the last rows. Changes to other rows drop the
+     * indexes with invalidateIndexes() instead.
+     */
+    void unindexRows(int first) const;
+    void indexRows(int first) const;
+
+    void invalidateIndexes();
+    /**
+     * Rebuilds the indexes if they were invalidated.
+     */
+    void ensureIndexes() const;
+
     KCalendarCore::Attendee::List mAttendeeList;
     std::vector<AvailableStatus> mAttendeeAvailable;
+
+    // The indexes are rebuilt on the next lookup after rows were inserted or
+    // removed before the last one, rather than shifting all rows after them.
+    mutable QHash<QString, QVector<int>> mEmailIndex; //!< the rows of each normalized email, ascending
+    mutable bool mIndexesValid = true;
+    // Attendee::uid() makes up a uid for attendees without one, so uids are
+    // only indexed for the rows a lookup went through, like a linear search would.
+    mutable QHash<QString, int> mUidIndex; //!< the first row of each uid of the rows before mUidIndexedRows
+    mutable int mUidIndexedRows = 0;
     bool mKeepEmpty = false;
     bool mRemoveEmptyLines = false;
 };
@@ -0,0 +1,183 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busybitmap.h"
+
+#include <QtAlgorithms>
+
+using namespace IncidenceEditorNG;
+
+static const int BITS_PER_WORD = 64;
+
+static inline int wordCount(int size)
+{
+    return (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+BusyBitmap::BusyBitmap(int size)
+    : mWords(wordCount(qMax(size, 0)), 0)
+    , mSize(qMax(size, 0))
+{
+}
+
+int BusyBitmap::size() const
+{
+    return mSize;
+}
+
+bool BusyBitmap::isEmpty() const
+{
+    return mSize == 0;
+}
+
+void BusyBitmap::clear()
+{
+    mWords.fill(0);
+}
+
+void BusyBitmap::setRange(int first, int count)
+{
+    int last = first + count; // exclusive
+    first = qMax(first, 0);
+    last = qMin(last, mSize);
+    if (first >= last) {
+        return;
+    }
+
+    const int firstWord = first / BITS_PER_WORD;
+    const int lastWord = (last - 1) / BITS_PER_WORD;
+    const quint64 firstMask = ~quint64(0) << (first % BITS_PER_WORD);
+    const quint64 lastMask = ~quint64(0) >> (BITS_PER_WORD - 1 - (last - 1) % BITS_PER_WORD);
+
+    quint64 *words = mWords.data();
+    if (firstWord == lastWord) {
+        words[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    words[firstWord] |= firstMask;
+    for (int i = firstWord + 1; i < lastWord; ++i) {
+        words[i] = ~quint64(0);
+    }
+    words[lastWord] |= lastMask;
+}
+
+bool BusyBitmap::testBit(int index) const
+{
+    Q_ASSERT(index >= 0 && index < mSize);
+    return (mWords.at(index / BITS_PER_WORD) >> (index % BITS_PER_WORD)) & 1;
+}
+
+int BusyBitmap::count() const
+{
+    int result = 0;
+    for (const quint64 word : mWords) {
+        result += qPopulationCount(word);
+    }
+    return result;
+}
+
+int BusyBitmap::nextSetBit(int from) const
+{
+    if (from >= mSize) {
+        return mSize;
+    }
+    from = qMax(from, 0);
+
+    const int words = mWords.size();
+    int i = from / BITS_PER_WORD;
+    quint64 word = mWords.at(i) & (~quint64(0) << (from % BITS_PER_WORD));
+    while (word == 0) {
+        if (++i == words) {
+            return mSize;
+        }
+        word = mWords.at(i);
+    }
+    return qMin(i * BITS_PER_WORD + int(qCountTrailingZeroBits(word)), mSize);
+}
+
+int BusyBitmap::nextClearBit(int from) const
+{
+    if (from >= mSize) {
+        return mSize;
+    }
+    from = qMax(from, 0);
+
+    // The unused bits of the last word are cleared, so the scan always stops
+    // at the latest one bit past the end; clamp that to mSize.
+    const int words = mWords.size();
+    int i = from / BITS_PER_WORD;
+    quint64 word = ~mWords.at(i) & (~quint64(0) << (from % BITS_PER_WORD));
+    while (word == 0) {
+        if (++i == words) {
+            return mSize;
+        }
+        word = ~mWords.at(i);
+    }
+    return qMin(i * BITS_PER_WORD + int(qCountTrailingZeroBits(word)), mSize);
+}
+
+void BusyBitmap::unite(const BusyBitmap &other)
+{
+    Q_ASSERT(other.mSize == mSize);
+
+    // Keep this a plain loop over raw pointers so it gets vectorized.
+    const int words = mWords.size();
+    quint64 *dst = mWords.data();
+    const quint64 *src = other.mWords.constData();
+    for (int i = 0; i < words; ++i) {
+        dst[i] |= src[i];
+    }
+}
+
+void BusyBitmap::subtract(const BusyBitmap &other)
+{
+    Q_ASSERT(other.mSize == mSize);
+
+    const int words = mWords.size();
+    quint64 *dst = mWords.data();
+    const quint64 *src = other.mWords.constData();
+    for (int i = 0; i < words; ++i) {
+        dst[i] &= ~src[i];
+    }
+}
+
+void BusyBitmap::addTo(QVector<int> &counts, int weight) const
+{
+    Q_ASSERT(counts.size() >= mSize);
+
+    // A word at a time, skipping the free ones. Within a word, the bits are
+    // turned into masks of the weight without branching, which leaves the
+    // loop to the compiler to vectorize.
+    int *data = counts.data();
+    const int words = mWords.size();
+    for (int w = 0; w < words; ++w) {
+        const quint64 word = mWords.at(w);
+        if (word == 0) {
+            continue;
+        }
+        int *slots = data + w * BITS_PER_WORD;
+        const int bits = qMin(BITS_PER_WORD, mSize - w * BITS_PER_WORD);
+        for (int bit = 0; bit < bits; ++bit) {
+            slots[bit] += weight & -int((word >> bit) & 1);
+        }
+    }
+}
+
+BusyBitmap BusyBitmap::fromCounts(const QVector<int> &counts, int maximum)
+{
+    BusyBitmap result(counts.size());
+    quint64 *words = result.mWords.data();
+    const int *data = counts.constData();
+    for (int i = 0; i < result.mSize; ++i) {
+        words[i / BITS_PER_WORD] |= quint64(data[i] > maximum) << (i % BITS_PER_WORD);
+    }
+    return result;
+}
+
+bool BusyBitmap::operator==(const BusyBitmap &other) const
+{
+    return mSize == other.mSize && mWords == other.mWords;
+}
@@ -0,0 +1,98 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor_private_export.h"
+
+#include <QVector>
+
+namespace IncidenceEditorNG
+{
+/**
+ * A fixed size row of busy/free time slots, packed 64 slots per word.
+ *
+ * ConflictResolver keeps one of these per attendee: a set bit marks a busy
+ * slot, a cleared bit a free one. Ranges are set with word masks rather than
+ * slot by slot, rows are combined with a plain word loop the compiler can
+ * vectorize, and free runs are located with count-trailing-zero scanning.
+ *
+ * Bits beyond size() are always kept cleared.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT BusyBitmap
+{
+public:
+    BusyBitmap() = default;
+
+    /**
+     * Creates a bitmap of @p size slots, all of them free.
+     */
+    explicit BusyBitmap(int size);
+
+    Q_REQUIRED_RESULT int size() const;
+    Q_REQUIRED_RESULT bool isEmpty() const;
+
+    /**
+     * Marks all slots as free, keeping the size.
+     */
+    void clear();
+
+    /**
+     * Marks @p count slots starting at @p first as busy. The range is clipped
+     * to the bitmap, an empty or negative range is a no-op.
+     */
+    void setRange(int first, int count);
+
+    Q_REQUIRED_RESULT bool testBit(int index) const;
+
+    /**
+     * Returns the number of busy slots.
+     */
+    Q_REQUIRED_RESULT int count() const;
+
+    /**
+     * Returns the index of the first busy slot at or after @p from,
+     * or size() if there is none.
+     */
+    Q_REQUIRED_RESULT int nextSetBit(int from) const;
+
+    /**
+     * Returns the index of the first free slot at or after @p from,
+     * or size() if there is none.
+     */
+    Q_REQUIRED_RESULT int nextClearBit(int from) const;
+
+    /**
+     * Marks every slot busy in @p other as busy in this bitmap as well.
+     * Both bitmaps must have the same size.
+     */
+    void unite(const BusyBitmap &other);
+
+    /**
+     * Marks every slot busy in @p other as free in this bitmap.
+     * Both bitmaps must have the same size.
+     */
+    void subtract(const BusyBitmap &other);
+
+    /**
+     * Adds @p weight to the entries of @p counts matching the busy slots.
+     * @p counts must hold at least size() entries.
+     */
+    void addTo(QVector<int> &counts, int weight) const;
+
+    /**
+     * Returns a bitmap in which a slot is busy if its entry in @p counts is
+     * greater than @p maximum.
+     */
+    Q_REQUIRED_RESULT static BusyBitmap fromCounts(const QVector<int> &counts, int maximum = 0);
+
+    Q_REQUIRED_RESULT bool operator==(const BusyBitmap &other) const;
+
+private:
+    QVector<quint64> mWords;
+    int mSize = 0;
+};
+}
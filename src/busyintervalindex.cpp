@@ -0,0 +1,156 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busyintervalindex.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace IncidenceEditorNG;
+
+BusyIntervalIndex::BusyIntervalIndex(const KCalendarCore::Period::List &periods)
+{
+    mIntervals.reserve(periods.size());
+    for (const KCalendarCore::Period &period : periods) {
+        const qint64 start = period.start().toMSecsSinceEpoch();
+        const qint64 end = period.end().toMSecsSinceEpoch();
+        if (start <= end) {
+            mIntervals.append({start, end});
+        }
+    }
+    normalize();
+}
+
+BusyIntervalIndex BusyIntervalIndex::united(const QVector<BusyIntervalIndex> &indexes)
+{
+    BusyIntervalIndex result;
+    int total = 0;
+    for (const BusyIntervalIndex &index : indexes) {
+        total += index.mIntervals.size();
+    }
+    result.mIntervals.reserve(total);
+    for (const BusyIntervalIndex &index : indexes) {
+        result.mIntervals += index.mIntervals;
+    }
+    result.normalize();
+    return result;
+}
+
+int BusyIntervalIndex::size() const
+{
+    return mIntervals.size();
+}
+
+bool BusyIntervalIndex::isEmpty() const
+{
+    return mIntervals.isEmpty();
+}
+
+void BusyIntervalIndex::normalize()
+{
+    std::sort(mIntervals.begin(), mIntervals.end(), [](const Interval &lhs, const Interval &rhs) {
+        return lhs.start < rhs.start || (lhs.start == rhs.start && lhs.end < rhs.end);
+    });
+
+    // Only merge intervals which really overlap. Touching ones are kept
+    // apart, so a range ending where one starts does not conflict with the
+    // other. This keeps the ends sorted as well.
+    int merged = 0;
+    for (int i = 0; i < mIntervals.size(); ++i) {
+        const Interval &interval = mIntervals.at(i);
+        if (merged > 0 && interval.start < mIntervals.at(merged - 1).end) {
+            Interval &last = mIntervals[merged - 1];
+            last.end = qMax(last.end, interval.end);
+        } else {
+            mIntervals[merged++] = interval;
+        }
+    }
+    mIntervals.resize(merged);
+}
+
+qint64 BusyIntervalIndex::nextFree(qint64 from, qint64 duration) const
+{
+    // Skip all intervals ending before the range starts
+    auto it = std::upper_bound(mIntervals.cbegin(), mIntervals.cend(), from, [](qint64 value, const Interval &interval) {
+        return value < interval.end;
+    });
+
+    // Every interval in the way pushes the range past its end; as the
+    // intervals are sorted and disjoint, none of the skipped ones can be
+    // in the way again.
+    for (const auto end = mIntervals.cend(); it != end && it->start < from + duration; ++it) {
+        if (it->end > from && it->start < from + duration) {
+            from = it->end;
+        }
+    }
+    return from;
+}
+
+qint64 BusyIntervalIndex::nextBusy(qint64 from) const
+{
+    // The ends are sorted as well, so the first interval ending after
+    // from is the one starting earliest among those.
+    const auto it = std::upper_bound(mIntervals.cbegin(), mIntervals.cend(), from, [](qint64 value, const Interval &interval) {
+        return value < interval.end;
+    });
+    return it != mIntervals.cend() ? it->start : std::numeric_limits<qint64>::max();
+}
+
+bool BusyIntervalIndex::tryDate(QDateTime &tryFrom, QDateTime &tryTo) const
+{
+    const qint64 from = tryFrom.toMSecsSinceEpoch();
+    const qint64 secsDuration = tryFrom.secsTo(tryTo);
+    const qint64 freeFrom = nextFree(from, secsDuration * 1000);
+    if (freeFrom == from) {
+        return true;
+    }
+    tryFrom = tryFrom.addMSecs(freeFrom - from);
+    tryTo = tryFrom.addSecs(secsDuration);
+    return false;
+}
+
+bool BusyIntervalIndex::intersects(qint64 from, qint64 to) const
+{
+    // The ends are sorted as well, so the first interval ending after
+    // from is the one starting earliest among those.
+    auto it = std::upper_bound(mIntervals.cbegin(), mIntervals.cend(), from, [](qint64 value, const Interval &interval) {
+        return value < interval.end;
+    });
+    return it != mIntervals.cend() && it->start <= to;
+}
+
+BusyIntervalIndex::Cursor::Cursor(const BusyIntervalIndex &index)
+    : mIntervals(index.mIntervals)
+{
+}
+
+void BusyIntervalIndex::Cursor::skipTo(qint64 from)
+{
+    // The ends are sorted, so the intervals ending before the range can be
+    // skipped for good; the first remaining one is the only candidate.
+    const int size = mIntervals.size();
+    while (mPosition < size && mIntervals.at(mPosition).end <= from) {
+        ++mPosition;
+    }
+}
+
+bool BusyIntervalIndex::Cursor::conflicts(qint64 from, qint64 duration)
+{
+    skipTo(from);
+    return mPosition < mIntervals.size() && mIntervals.at(mPosition).start < from + duration;
+}
+
+qint64 BusyIntervalIndex::Cursor::nextChange(qint64 from, qint64 duration)
+{
+    skipTo(from);
+    if (mPosition == mIntervals.size()) {
+        return std::numeric_limits<qint64>::max();
+    }
+    // A conflict lasts until the range starts at the end of the interval,
+    // otherwise one begins once the range ends after its start.
+    const Interval &interval = mIntervals.at(mPosition);
+    return interval.start < from + duration ? interval.end : interval.start - duration + 1;
+}
@@ -0,0 +1,124 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor_private_export.h"
+
+#include <KCalendarCore/Period>
+
+#include <QVector>
+
+namespace IncidenceEditorNG
+{
+/**
+ * The busy periods of an attendee, compiled into a sorted array of
+ * non-overlapping intervals.
+ *
+ * Checking whether a time range is free and locating the next free time
+ * range of a given length are a binary search followed by a walk over the
+ * busy intervals actually in the way, instead of a scan over all periods.
+ *
+ * A time range conflicts with a busy period if they overlap by more than
+ * their boundaries, a meeting may start right when a busy period ends.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT BusyIntervalIndex
+{
+public:
+    BusyIntervalIndex() = default;
+
+    /**
+     * Compiles @p periods into an index. The periods need not be sorted and
+     * may overlap.
+     */
+    explicit BusyIntervalIndex(const KCalendarCore::Period::List &periods);
+
+    /**
+     * Returns the index of the times at least one of @p indexes is busy at.
+     */
+    Q_REQUIRED_RESULT static BusyIntervalIndex united(const QVector<BusyIntervalIndex> &indexes);
+
+    /**
+     * Returns the number of busy intervals left after merging overlapping periods.
+     */
+    Q_REQUIRED_RESULT int size() const;
+    Q_REQUIRED_RESULT bool isEmpty() const;
+
+    /**
+     * Returns the earliest start at or after @p from of a range of
+     * @p duration milliseconds which conflicts with no busy interval.
+     * Both are given in milliseconds since the epoch.
+     */
+    Q_REQUIRED_RESULT qint64 nextFree(qint64 from, qint64 duration) const;
+
+    /**
+     * Returns the start of the first busy interval ending after @p from, in
+     * milliseconds since the epoch, or the largest qint64 if there is none.
+     */
+    Q_REQUIRED_RESULT qint64 nextBusy(qint64 from) const;
+
+    /**
+     * Checks whether (@p tryFrom, @p tryTo) is free. If it is not, moves it
+     * to the next free range of the same length and returns false.
+     */
+    bool tryDate(QDateTime &tryFrom, QDateTime &tryTo) const;
+
+    /**
+     * Returns whether a busy interval starts at or before @p to and ends
+     * after @p from, both given in milliseconds since the epoch. Unlike for
+     * the free slot search, an interval starting right at @p to counts.
+     */
+    Q_REQUIRED_RESULT bool intersects(qint64 from, qint64 to) const;
+
+private:
+    struct Interval {
+        qint64 start; //!< msecs since epoch
+        qint64 end; //!< msecs since epoch
+    };
+
+public:
+    /**
+     * Checks ranges moving forward in time against an index, in amortized
+     * constant time per range. The index must outlive the cursor.
+     */
+    class Cursor
+    {
+    public:
+        explicit Cursor(const BusyIntervalIndex &index);
+
+        /**
+         * Returns whether the range of @p duration milliseconds starting at
+         * @p from conflicts with a busy interval. @p from must not be smaller
+         * than in the previous call.
+         */
+        Q_REQUIRED_RESULT bool conflicts(qint64 from, qint64 duration);
+
+        /**
+         * Returns the earliest start after @p from at which a range of
+         * @p duration milliseconds may conflict differently than the one
+         * starting at @p from, or the largest qint64 if there is none.
+         * @p from must not be smaller than in the previous call.
+         */
+        Q_REQUIRED_RESULT qint64 nextChange(qint64 from, qint64 duration);
+
+    private:
+        void skipTo(qint64 from);
+
+        const QVector<Interval> &mIntervals;
+        int mPosition = 0;
+    };
+
+private:
+
+    /**
+     * Sorts mIntervals and merges the overlapping ones.
+     */
+    void normalize();
+
+    QVector<Interval> mIntervals;
+};
+}
+
@@ -0,0 +1,154 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "busyrowcache.h"
+
+using namespace IncidenceEditorNG;
+
+BusyRowCache::BusyRowCache(const SlotGrid &grid, bool weighted)
+    : mGrid(grid)
+    , mBusySlots(grid.range())
+    , mBusyCounts(weighted ? grid.range() : 0, 0)
+    , mWeighted(weighted)
+{
+}
+
+SlotGrid BusyRowCache::grid() const
+{
+    return mGrid;
+}
+
+int BusyRowCache::range() const
+{
+    return mGrid.range();
+}
+
+bool BusyRowCache::isWeighted() const
+{
+    return mWeighted;
+}
+
+void BusyRowCache::beginUpdate()
+{
+    for (auto it = mRows.begin(), end = mRows.end(); it != end; ++it) {
+        it->pendingWeight = 0;
+        it->pendingTentativeWeight = 0;
+    }
+}
+
+void BusyRowCache::addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy)
+{
+    addFreeBusy(freeBusy, 1, 1);
+}
+
+void BusyRowCache::addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy, int weight, int tentativeWeight)
+{
+    auto it = mRows.find(freeBusy.data());
+    if (it == mRows.end()) {
+        it = mRows.insert(freeBusy.data(), makeRow(freeBusy));
+    }
+    it->pendingWeight += weight;
+    it->pendingTentativeWeight += tentativeWeight;
+}
+
+void BusyRowCache::endUpdate()
+{
+    bool unionChanged = false;
+    for (auto it = mRows.begin(); it != mRows.end();) {
+        if (it->pendingWeight != it->weight) {
+            if (mWeighted) {
+                it->busy.addTo(mBusyCounts, it->pendingWeight - it->weight);
+            }
+            unionChanged |= (it->pendingWeight == 0) != (it->weight == 0);
+            it->weight = it->pendingWeight;
+            ++mRevision;
+        }
+        if (it->pendingTentativeWeight != it->tentativeWeight) {
+            if (mWeighted) {
+                it->tentative.addTo(mBusyCounts, it->pendingTentativeWeight - it->tentativeWeight);
+            }
+            unionChanged |= (it->pendingTentativeWeight == 0) != (it->tentativeWeight == 0);
+            it->tentativeWeight = it->pendingTentativeWeight;
+            ++mRevision;
+        }
+        if (it->weight == 0 && it->tentativeWeight == 0) {
+            it = mRows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (unionChanged) {
+        // Rebuilding it a word at a time is cheaper than keeping counts
+        mBusySlots = BusyBitmap(mGrid.range());
+        for (const Row &row : qAsConst(mRows)) {
+            if (row.weight != 0) {
+                mBusySlots.unite(row.busy);
+            }
+            if (row.tentativeWeight != 0) {
+                mBusySlots.unite(row.tentative);
+            }
+        }
+    }
+}
+
+int BusyRowCache::revision() const
+{
+    return mRevision;
+}
+
+QVector<int> BusyRowCache::busyCounts() const
+{
+    if (mWeighted) {
+        return mBusyCounts;
+    }
+
+    QVector<int> counts(mGrid.range(), 0);
+    for (const Row &row : mRows) {
+        row.busy.addTo(counts, row.weight);
+        row.tentative.addTo(counts, row.tentativeWeight);
+    }
+    return counts;
+}
+
+BusyBitmap BusyRowCache::busySlots() const
+{
+    return mBusySlots;
+}
+
+BusyBitmap BusyRowCache::busyRow(const KCalendarCore::FreeBusy::Ptr &freeBusy) const
+{
+    const Row row = makeRow(freeBusy);
+    BusyBitmap busy = row.busy;
+    busy.unite(row.tentative);
+    return busy;
+}
+
+BusyRowCache::Row BusyRowCache::makeRow(const KCalendarCore::FreeBusy::Ptr &freeBusy) const
+{
+    Row row;
+    row.freeBusy = freeBusy;
+    row.busy = BusyBitmap(mGrid.range());
+    row.tentative = BusyBitmap(mGrid.range());
+    if (!freeBusy) {
+        return row;
+    }
+    const KCalendarCore::FreeBusyPeriod::List busyPeriods = freeBusy->fullBusyPeriods();
+    for (const auto &period : busyPeriods) {
+        int first;
+        int count;
+        if (mGrid.slotSpan(period, &first, &count)) {
+            if (period.type() == KCalendarCore::FreeBusyPeriod::BusyTentative) {
+                row.tentative.setRange(first, count);
+            } else {
+                row.busy.setRange(first, count);
+            }
+        }
+    }
+    // A slot both busy and tentatively busy counts as busy only
+    row.tentative.subtract(row.busy);
+    return row;
+}
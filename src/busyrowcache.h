@@ -0,0 +1,126 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "busybitmap.h"
+#include "slotgrid.h"
+#include "incidenceeditor_private_export.h"
+
+#include <KCalendarCore/FreeBusy>
+
+#include <QHash>
+#include <QVector>
+
+namespace IncidenceEditorNG
+{
+/**
+ * Keeps the busy slots of a set of FreeBusy objects on one slot grid, along
+ * with the union of them. A weighted cache also keeps the summed weight of
+ * the objects being busy in each slot.
+ *
+ * Rows are keyed by the FreeBusy object, which is replaced rather than
+ * modified when new free/busy data arrives. Updating the cache with the
+ * current FreeBusy objects therefore only converts the ones not seen before.
+ * The union is only rebuilt, word by word, when rows came or went, and the
+ * weights of a weighted cache only add or subtract the rows which changed.
+ *
+ * Usage:
+ * @code
+ * cache.beginUpdate();
+ * for (const auto &fb : freeBusyList) {
+ *     cache.addFreeBusy(fb);
+ * }
+ * cache.endUpdate();
+ * @endcode
+ *
+ * The cache is a value type and not thread safe; a copy may be updated in
+ * another thread though.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT BusyRowCache
+{
+public:
+    BusyRowCache() = default;
+
+    /**
+     * Creates an empty cache for the slots of @p grid. A @p weighted cache
+     * keeps busyCounts() up to date with every update, otherwise they are
+     * only computed when asked for.
+     */
+    explicit BusyRowCache(const SlotGrid &grid, bool weighted = false);
+
+    Q_REQUIRED_RESULT SlotGrid grid() const;
+    Q_REQUIRED_RESULT bool isWeighted() const;
+
+    /**
+     * Returns the number of slots of the grid.
+     */
+    Q_REQUIRED_RESULT int range() const;
+
+    void beginUpdate();
+    /**
+     * Adds @p freeBusy to the update in progress. An object added n times
+     * counts n times.
+     */
+    void addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy);
+    /**
+     * Adds @p freeBusy to the update in progress, with @p weight counted for
+     * the slots it is busy in and @p tentativeWeight for the ones it is
+     * only tentatively busy in. Weights of an object added several times add up.
+     */
+    void addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy, int weight, int tentativeWeight);
+    /**
+     * Applies the difference between the objects added since beginUpdate()
+     * and the ones of the previous update to busySlots() and busyCounts().
+     */
+    void endUpdate();
+
+    /**
+     * Returns a number which changes whenever an update changes the rows or
+     * their weights, and thus possibly busySlots() and busyCounts().
+     */
+    Q_REQUIRED_RESULT int revision() const;
+
+    /**
+     * Returns for each slot the summed weight of the added FreeBusy objects
+     * being busy in it, which is their number unless weights were given.
+     * This goes through all rows unless the cache is weighted.
+     */
+    Q_REQUIRED_RESULT QVector<int> busyCounts() const;
+
+    /**
+     * Returns a bitmap of the slots any of the added FreeBusy objects is busy in.
+     */
+    Q_REQUIRED_RESULT BusyBitmap busySlots() const;
+
+    /**
+     * Returns the busy slots of @p freeBusy on the grid.
+     */
+    Q_REQUIRED_RESULT BusyBitmap busyRow(const KCalendarCore::FreeBusy::Ptr &freeBusy) const;
+
+private:
+    struct Row {
+        KCalendarCore::FreeBusy::Ptr freeBusy; //!< keeps the key alive
+        BusyBitmap busy; //!< the slots of all but the tentative busy periods
+        BusyBitmap tentative; //!< the slots only tentative busy periods cover
+        int weight = 0; //!< the weight of busy, in mBusySlots unless 0
+        int tentativeWeight = 0; //!< the weight of tentative, in mBusySlots unless 0
+        int pendingWeight = 0; //!< the weights added in the update in progress
+        int pendingTentativeWeight = 0;
+    };
+
+    Q_REQUIRED_RESULT Row makeRow(const KCalendarCore::FreeBusy::Ptr &freeBusy) const;
+
+    SlotGrid mGrid;
+
+    QHash<const KCalendarCore::FreeBusy *, Row> mRows;
+    BusyBitmap mBusySlots;
+    QVector<int> mBusyCounts; //!< weighted caches only
+    bool mWeighted = false;
+    int mRevision = 0;
+};
+}
+
@@ -32,6 +32,10 @@ void CombinedIncidenceEditor::combine(IncidenceEditor *other)
 
 bool CombinedIncidenceEditor::isDirty() const
 {
+    // Bring mDirtyEditorCount up to date with the checks still scheduled
+    for (IncidenceEditor *editor : qAsConst(mCombinedEditors)) {
+        editor->flushDirtyStatus();
+    }
     return mDirtyEditorCount > 0;
 }
 
@@ -137,3 +141,19 @@ void CombinedIncidenceEditor::save(Akonadi::Item &item)
         editor->save(item);
     }
 }
+
+void CombinedIncidenceEditor::reset()
+{
+    for (IncidenceEditor *editor : qAsConst(mCombinedEditors)) {
+        // Run the checks still scheduled now, so they can't count against the
+        // next incidence.
+        editor->blockSignals(true);
+        editor->flushDirtyStatus();
+        editor->blockSignals(false);
+    }
+
+    mLoadedIncidence.clear();
+    mWasDirty = false;
+    mDirtyEditorCount = 0;
+    Q_EMIT dirtyStatusChanged(false);
+}
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "incidenceeditor-ng.h"
+#include "incidenceeditor_private_export.h"
 
 #include <AkonadiCore/Item>
 #include <KMessageWidget>
@@ -19,7 +20,7 @@ namespace IncidenceEditorNG
  * IncidenceEditors. The CombinedIncidenceEditor keeps track of the dirty state
  * of the IncidenceEditors that where combined.
  */
-class CombinedIncidenceEditor : public IncidenceEditor
+class INCIDENCEEDITOR_TESTS_EXPORT CombinedIncidenceEditor : public IncidenceEditor
 {
     Q_OBJECT
 public:
@@ -49,6 +50,13 @@ public:
     void save(const KCalendarCore::Incidence::Ptr &incidence) override;
     void save(Akonadi::Item &item) override;
 
+    /**
+     * Forgets the loaded incidence and the dirty status of all combined
+     * editors, without recreating them. The editors get their values again
+     * with the next load().
+     */
+    void reset();
+
 Q_SIGNALS:
     void showMessage(const QString &reason, KMessageWidget::MessageType) const;
 
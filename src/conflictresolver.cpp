@@ -8,12 +8,26 @@
 */
 
 #include "conflictresolver.h"
+#include "busybitmap.h"
+#include "busyintervalindex.h"
+#include "busyrowcache.h"
+#include "freebusycache.h"
+#include "slotgrid.h"
 #include "incidenceeditor_debug.h"
 #include <CalendarSupport/FreeBusyItemModel>
 
 #include <QDate>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 static const int DEFAULT_RESOLUTION_SECONDS = 15 * 60; // 15 minutes, 1 slot = 15 minutes
+// Weighted conflicts are summed up in hundredths of a role weight, so
+// tentative conflicts keep their share of small weights
+static const int WEIGHT_SCALE = 100;
 
 using namespace IncidenceEditorNG;
 
@@ -22,7 +36,9 @@ ConflictResolver::ConflictResolver(QWidget *parentWidget, QObject *parent)
     , mFBModel(new CalendarSupport::FreeBusyItemModel(this))
     , mParentWidget(parentWidget)
     , mWeekdays(7)
+    , mAllowedHours(7)
     , mSlotResolutionSeconds(DEFAULT_RESOLUTION_SECONDS)
+    , mSearchGeneration(new QAtomicInt(0))
 {
     const QDateTime currentLocalDateTime = QDateTime::currentDateTime();
     mTimeframeConstraint = KCalendarCore::Period(currentLocalDateTime, currentLocalDateTime);
@@ -40,20 +56,51 @@ ConflictResolver::ConflictResolver(QWidget *parentWidget, QObject *parent)
     mWeekdays.setBit(5);
     mWeekdays.setBit(6); // Sunday
 
+    mRoleWeights.insert(KCalendarCore::Attendee::Chair, 8);
+    mRoleWeights.insert(KCalendarCore::Attendee::ReqParticipant, 6);
+    mRoleWeights.insert(KCalendarCore::Attendee::OptParticipant, 2);
+    mRoleWeights.insert(KCalendarCore::Attendee::NonParticipant, 0);
+
     mMandatoryRoles.reserve(4);
     mMandatoryRoles << KCalendarCore::Attendee::ReqParticipant << KCalendarCore::Attendee::OptParticipant << KCalendarCore::Attendee::NonParticipant
                     << KCalendarCore::Attendee::Chair;
 
+    connect(mFBModel, &CalendarSupport::FreeBusyItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        if (!topLeft.parent().isValid()) {
+            cacheFreeBusy(topLeft.row(), bottomRight.row());
+        }
+    });
     connect(mFBModel, &CalendarSupport::FreeBusyItemModel::dataChanged, this, &ConflictResolver::freebusyDataChanged);
 
-    connect(&mCalculateTimer, &QTimer::timeout, this, &ConflictResolver::findAllFreeSlots);
+    connect(FreeBusyCache::instance(), &FreeBusyCache::prefetchFailed, this, [this](const QString &email) {
+        // Download the data of the items which waited for it after all
+        const QList<QWeakPointer<CalendarSupport::FreeBusyItem>> items = mPrefetchedItems.values(email.toLower());
+        mPrefetchedItems.remove(email.toLower());
+        for (const QWeakPointer<CalendarSupport::FreeBusyItem> &weakItem : items) {
+            const CalendarSupport::FreeBusyItem::Ptr item = weakItem.toStrongRef();
+            if (item && item->updateTimerID() == 0) {
+                item->setUpdateTimerID(mFBModel->startTimer(0));
+            }
+        }
+    });
+
+    connect(&mCalculateTimer, &QTimer::timeout, this, &ConflictResolver::startFreeSlotSearch);
     mCalculateTimer.setSingleShot(true);
 }
 
+ConflictResolver::~ConflictResolver()
+{
+    // Let a search still running in the background bail out early.
+    mSearchGeneration->ref();
+}
+
 void ConflictResolver::insertAttendee(const KCalendarCore::Attendee &attendee)
 {
     if (!mFBModel->containsAttendee(attendee)) {
-        mFBModel->addItem(CalendarSupport::FreeBusyItem::Ptr(new CalendarSupport::FreeBusyItem(attendee, mParentWidget)));
+        if (addFreeBusyItem(attendee)) {
+            // came with cached data, no dataChanged() to wait for
+            calculateConflicts();
+        }
     }
 }
 
@@ -64,12 +111,139 @@ void ConflictResolver::insertAttendee(const CalendarSupport::FreeBusyItem::Ptr &
     }
 }
 
+void ConflictResolver::insertAttendees(const KCalendarCore::Attendee::List &attendees)
+{
+    if (attendees.isEmpty()) {
+        return;
+    }
+    // FreeBusyItemModel::containsAttendee() is a linear search, look the
+    // attendees up by email instead.
+    QMultiHash<QString, KCalendarCore::Attendee> present;
+    for (int i = 0; i < mFBModel->rowCount(); ++i) {
+        const auto attendee = mFBModel->data(mFBModel->index(i), CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
+        present.insert(attendee.email(), attendee);
+    }
+    bool cached = false;
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        if (present.values(attendee.email()).contains(attendee)) {
+            continue;
+        }
+        present.insert(attendee.email(), attendee);
+        cached |= addFreeBusyItem(attendee);
+    }
+    if (cached) {
+        calculateConflicts();
+    }
+}
+
+bool ConflictResolver::addFreeBusyItem(const KCalendarCore::Attendee &attendee)
+{
+    CalendarSupport::FreeBusyItem::Ptr item(new CalendarSupport::FreeBusyItem(attendee, mParentWidget));
+    bool fresh = false;
+    const KCalendarCore::FreeBusy::Ptr freeBusy = FreeBusyCache::instance()->freeBusy(attendee.email(), &fresh);
+    if (freeBusy) {
+        item->setFreeBusy(freeBusy);
+        mCachedFreeBusy.insert(attendee.email().toLower(), freeBusy);
+    }
+    mFBModel->addItem(item);
+
+    // addItem() schedules the download of the item on a timer. Cancel it
+    // while the cached data is fresh, or while FreeBusyCache::prefetch() is
+    // fetching it anyway: the model gets that data too. Later reloads still
+    // go through.
+    const bool prefetching = !fresh && FreeBusyCache::instance()->isPrefetching(attendee.email());
+    if ((fresh || prefetching) && item->updateTimerID() != 0) {
+        mFBModel->killTimer(item->updateTimerID());
+        item->setUpdateTimerID(0);
+        if (prefetching) {
+            mPrefetchedItems.insert(attendee.email().toLower(), item);
+        }
+    }
+    return !freeBusy.isNull();
+}
+
+void ConflictResolver::cacheFreeBusy(int first, int last)
+{
+    for (int i = first; i <= last; ++i) {
+        const QModelIndex index = mFBModel->index(i);
+        const auto attendee = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
+        const auto freeBusy = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
+        const QString email = attendee.email().toLower();
+        if (!freeBusy || email.isEmpty()) {
+            continue;
+        }
+        mPrefetchedItems.remove(email);
+        // Do not refresh the timestamp of what came from the cache
+        if (mCachedFreeBusy.value(email).toStrongRef() == freeBusy) {
+            continue;
+        }
+        mCachedFreeBusy.remove(email);
+        FreeBusyCache::instance()->insert(email, freeBusy);
+    }
+}
+
 void ConflictResolver::removeAttendee(const KCalendarCore::Attendee &attendee)
 {
     mFBModel->removeAttendee(attendee);
     calculateConflicts();
 }
 
+void ConflictResolver::removeAttendees(const KCalendarCore::Attendee::List &attendees)
+{
+    if (attendees.isEmpty()) {
+        return;
+    }
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        mFBModel->removeAttendee(attendee);
+    }
+    calculateConflicts();
+}
+
+// Removes one attendee equal to @p attendee from @p attendees, if there is one.
+static bool takeAttendee(QMultiHash<QString, KCalendarCore::Attendee> &attendees, const KCalendarCore::Attendee &attendee)
+{
+    for (auto it = attendees.find(attendee.email()); it != attendees.end() && it.key() == attendee.email(); ++it) {
+        if (it.value() == attendee) {
+            attendees.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConflictResolver::setAttendees(const KCalendarCore::Attendee::List &attendees)
+{
+    // Diff by email, so this stays linear in the number of attendees
+    QMultiHash<QString, KCalendarCore::Attendee> added;
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        added.insert(attendee.email(), attendee);
+    }
+
+    KCalendarCore::Attendee::List removed;
+    for (int i = 0; i < mFBModel->rowCount(); ++i) {
+        const auto attendee = mFBModel->data(mFBModel->index(i), CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
+        // keep the ones still there with their free/busy data
+        if (!takeAttendee(added, attendee)) {
+            removed.append(attendee);
+        }
+    }
+
+    for (const KCalendarCore::Attendee &attendee : qAsConst(removed)) {
+        mFBModel->removeAttendee(attendee);
+    }
+    // Add the new ones in the order given
+    bool cached = false;
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        if (takeAttendee(added, attendee)) {
+            cached |= addFreeBusyItem(attendee);
+        }
+    }
+
+    if (!removed.isEmpty() || cached) {
+        calculateConflicts();
+    }
+}
+
 void ConflictResolver::clearAttendees()
 {
     mFBModel->clear();
@@ -129,50 +303,66 @@ void ConflictResolver::freebusyDataChanged()
     calculateConflicts();
 }
 
-int ConflictResolver::tryDate(QDateTime &tryFrom, QDateTime &tryTo)
+QVector<BusyIntervalIndex> ConflictResolver::attendeeIntervalIndexes(QVector<BusyIntervalIndex> *optionalIndexes)
 {
-    int conflicts_count = 0;
+    // Compile the busy periods of each FreeBusy object only once. The ones
+    // compiled by busyIntervals() for the other attendees are kept as well,
+    // only the ones of FreeBusy objects no longer in the model are dropped.
+    QVector<BusyIntervalIndex> indexes;
+    QSet<const KCalendarCore::FreeBusy *> inUse;
     for (int i = 0; i < mFBModel->rowCount(); ++i) {
         QModelIndex index = mFBModel->index(i);
-        auto attendee = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        if (!matchesRoleConstraint(attendee)) {
+        auto freebusy = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
+        // If we don't have any free/busy information, assume the
+        // participant is free. Otherwise a participant without available
+        // information would block the whole allocation.
+        if (!freebusy) {
             continue;
         }
-        auto freebusy = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
-        if (!tryDate(freebusy, tryFrom, tryTo)) {
-            ++conflicts_count;
+        inUse.insert(freebusy.data());
+
+        auto attendee = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
+        const bool mandatory = matchesRoleConstraint(attendee);
+        if (mandatory) {
+            indexes.append(busyIntervals(freebusy));
+        } else if (optionalIndexes) {
+            optionalIndexes->append(busyIntervals(freebusy));
         }
     }
-    return conflicts_count;
+    if (mIntervalIndexes.size() > inUse.size()) {
+        for (auto it = mIntervalIndexes.begin(); it != mIntervalIndexes.end();) {
+            if (inUse.contains(it.key())) {
+                ++it;
+            } else {
+                it = mIntervalIndexes.erase(it);
+            }
+        }
+    }
+    return indexes;
 }
 
-bool ConflictResolver::tryDate(const KCalendarCore::FreeBusy::Ptr &fb, QDateTime &tryFrom, QDateTime &tryTo)
+BusyIntervalIndex ConflictResolver::busyIntervals(const KCalendarCore::FreeBusy::Ptr &freeBusy)
 {
-    // If we don't have any free/busy information, assume the
-    // participant is free. Otherwise a participant without available
-    // information would block the whole allocation.
-    if (!fb) {
-        return true;
+    if (!freeBusy) {
+        return BusyIntervalIndex();
+    }
+    auto it = mIntervalIndexes.find(freeBusy.data());
+    if (it == mIntervalIndexes.end()) {
+        it = mIntervalIndexes.insert(freeBusy.data(), {freeBusy, BusyIntervalIndex(freeBusy->busyPeriods())});
     }
+    return it->index;
+}
 
-    KCalendarCore::Period::List busyPeriods = fb->busyPeriods();
-    for (auto it = busyPeriods.begin(); it != busyPeriods.end(); ++it) {
-        if ((*it).end() <= tryFrom // busy period ends before try period
-            || (*it).start() >= tryTo) { // busy period starts after try period
-            continue;
-        } else {
-            // the current busy period blocks the try period, try
-            // after the end of the current busy period
-            const qint64 secsDuration = tryFrom.secsTo(tryTo);
-            tryFrom = (*it).end();
-            tryTo = tryFrom.addSecs(secsDuration);
-            // try again with the new try period
-            tryDate(fb, tryFrom, tryTo);
-            // we had to change the date at least once
-            return false;
+int ConflictResolver::tryDate(QDateTime &tryFrom, QDateTime &tryTo)
+{
+    int conflicts_count = 0;
+    const QVector<BusyIntervalIndex> indexes = attendeeIntervalIndexes();
+    for (const BusyIntervalIndex &index : indexes) {
+        if (!index.tryDate(tryFrom, tryTo)) {
+            ++conflicts_count;
         }
     }
-    return true;
+    return conflicts_count;
 }
 
 bool ConflictResolver::findFreeSlot(const KCalendarCore::Period &dateTimeRange)
@@ -197,31 +387,252 @@ bool ConflictResolver::findFreeSlot(const KCalendarCore::Period &dateTimeRange)
         tryTo = tryFrom.addSecs(secs);
     }
 
-    bool found = false;
-    while (!found) {
-        found = tryDate(tryFrom, tryTo);
-        // PENDING(kalle) Make the interval configurable
-        if (!found && dtFrom.daysTo(tryFrom) > 365) {
-            break; // don't look more than one year in the future
+    // A slot is free for everybody if it is free in the union of all busy
+    // intervals, so a single lookup in there finds the earliest one.
+    const BusyIntervalIndex busy = BusyIntervalIndex::united(attendeeIntervalIndexes());
+    busy.tryDate(tryFrom, tryTo);
+
+    return dtFrom.daysTo(tryFrom) <= mSearchHorizonDays;
+}
+
+QVector<ConflictResolver::SlotCandidate> ConflictResolver::rankedFreeSlots(const KCalendarCore::Period &dateTimeRange, int count)
+{
+    QVector<SlotCandidate> ranked;
+    if (count <= 0) {
+        return ranked;
+    }
+
+    QVector<BusyIntervalIndex> optionalIndexes;
+    const BusyIntervalIndex mandatoryBusy = BusyIntervalIndex::united(attendeeIntervalIndexes(&optionalIndexes));
+    std::vector<BusyIntervalIndex::Cursor> optionalCursors;
+    optionalCursors.reserve(optionalIndexes.size());
+    for (const BusyIntervalIndex &index : qAsConst(optionalIndexes)) {
+        optionalCursors.emplace_back(index);
+    }
+
+    const QDateTime requested = dateTimeRange.start();
+    const qint64 requestedMSecs = requested.toMSecsSinceEpoch();
+    const qint64 duration = requested.secsTo(dateTimeRange.end()) * 1000;
+    const qint64 step = qMax(mSlotResolutionSeconds, 1) * qint64(1000);
+    // Slots have to start before the day after the horizon.
+    const qint64 horizonEnd = requested.date().addDays(mSearchHorizonDays + 1).startOfDay(requested.timeZone()).toMSecsSinceEpoch();
+    const SlotCostFunction slotCost = mSlotCostFunction ? mSlotCostFunction : SlotCostFunction(&ConflictResolver::defaultSlotCost);
+
+    // Make sure that we never suggest a date in the past, even if the
+    // user originally scheduled the meeting to be in the past.
+    qint64 position = qMax(requestedMSecs, QDateTime::currentMSecsSinceEpoch());
+
+    // A single pass forward in time, one stretch of slots at a time: jump
+    // over the times a mandatory attendee is busy, and within a free block
+    // end the stretch where an optional attendee's busy period or the
+    // working hours make a difference. The slots of a stretch only differ
+    // in their distance from the request, so only its first count slots
+    // can make it into the result.
+    for (;;) {
+        position = mandatoryBusy.nextFree(position, duration);
+        if (position >= horizonEnd) {
+            break;
+        }
+
+        const QDateTime stretchStart = requested.addMSecs(position - requestedMSecs);
+        const qint64 nextBusy = mandatoryBusy.nextBusy(position);
+        qint64 stretchEnd = qMin(horizonEnd, nextWorkingHoursChange(stretchStart, duration));
+        if (nextBusy != std::numeric_limits<qint64>::max()) {
+            stretchEnd = qMin(stretchEnd, nextBusy - duration + 1);
+        }
+        int busyOptionalAttendees = 0;
+        for (BusyIntervalIndex::Cursor &cursor : optionalCursors) {
+            if (cursor.conflicts(position, duration)) {
+                ++busyOptionalAttendees;
+            }
+            stretchEnd = qMin(stretchEnd, cursor.nextChange(position, duration));
         }
+        const bool withinWorkingHours = isWithinWorkingHours(KCalendarCore::Period(stretchStart, stretchStart.addMSecs(duration)));
+
+        for (int i = 0; i < count && position < stretchEnd; ++i, position += step) {
+            SlotCandidate candidate;
+            const QDateTime start = requested.addMSecs(position - requestedMSecs);
+            candidate.period = KCalendarCore::Period(start, start.addMSecs(duration));
+            candidate.secsFromRequest = requested.secsTo(start);
+            candidate.withinWorkingHours = withinWorkingHours;
+            candidate.busyOptionalAttendees = busyOptionalAttendees;
+            candidate.cost = slotCost(candidate);
+
+            // Keep the best ones; candidates come in time order, so inserting
+            // after the ones of equal cost keeps the earlier slots first.
+            const auto it = std::upper_bound(ranked.begin(), ranked.end(), candidate.cost, [](double cost, const SlotCandidate &other) {
+                return cost < other.cost;
+            });
+            if (ranked.size() < count || it != ranked.end()) {
+                ranked.insert(it, candidate);
+                if (ranked.size() > count) {
+                    ranked.removeLast();
+                }
+            }
+        }
+
+        // Continue with the first slot after the stretch
+        if (position < stretchEnd) {
+            position += (stretchEnd - position + step - 1) / step * step;
+        }
+    }
+    return ranked;
+}
+
+void ConflictResolver::setSearchHorizon(int days)
+{
+    if (days < 0) {
+        qCWarning(INCIDENCEEDITOR_LOG) << "Ignoring negative search horizon" << days;
+        return;
+    }
+    mSearchHorizonDays = days;
+}
+
+int ConflictResolver::searchHorizon() const
+{
+    return mSearchHorizonDays;
+}
+
+void ConflictResolver::setWorkingHours(const QTime &start, const QTime &end)
+{
+    if (start.isValid() && end.isValid() && end <= start && end != QTime(0, 0)) {
+        qCWarning(INCIDENCEEDITOR_LOG) << "Ignoring working hours ending before they start" << start << end;
+        return;
     }
+    mWorkingHoursStart = start;
+    mWorkingHoursEnd = end;
+}
 
-    dtFrom = tryFrom;
-    dtTo = tryTo;
+QPair<QDateTime, QDateTime> ConflictResolver::workingHoursOf(const QDateTime &dateTime) const
+{
+    QDateTime start = dateTime;
+    start.setTime(mWorkingHoursStart);
+    QDateTime end = dateTime;
+    if (mWorkingHoursEnd == QTime(0, 0)) {
+        end = dateTime.date().addDays(1).startOfDay(dateTime.timeZone());
+    } else {
+        end.setTime(mWorkingHoursEnd);
+    }
+    return {start, end};
+}
 
-    return found;
+bool ConflictResolver::isWithinWorkingHours(const KCalendarCore::Period &period) const
+{
+    if (!mWorkingHoursStart.isValid() || !mWorkingHoursEnd.isValid()) {
+        return true;
+    }
+    const QPair<QDateTime, QDateTime> hours = workingHoursOf(period.start());
+    return period.start() >= hours.first && period.end() <= hours.second;
 }
 
+qint64 ConflictResolver::nextWorkingHoursChange(const QDateTime &start, qint64 duration) const
+{
+    if (!mWorkingHoursStart.isValid() || !mWorkingHoursEnd.isValid()) {
+        return std::numeric_limits<qint64>::max();
+    }
+    // Slots are within the working hours from their start on, until they
+    // end after them; the next day starts over.
+    const QPair<QDateTime, QDateTime> today = workingHoursOf(start);
+    const qint64 changes[] = {today.first.toMSecsSinceEpoch(),
+                              today.second.toMSecsSinceEpoch() - duration + 1,
+                              workingHoursOf(start.addDays(1)).first.toMSecsSinceEpoch()};
+    const qint64 position = start.toMSecsSinceEpoch();
+    qint64 next = std::numeric_limits<qint64>::max();
+    for (const qint64 change : changes) {
+        if (change > position) {
+            next = qMin(next, change);
+        }
+    }
+    return next;
+}
+
+void ConflictResolver::setSlotCostFunction(const SlotCostFunction &function)
+{
+    mSlotCostFunction = function;
+}
+
+double ConflictResolver::defaultSlotCost(const SlotCandidate &candidate)
+{
+    static const double SECS_PER_DAY = 24 * 60 * 60;
+    return candidate.busyOptionalAttendees + (candidate.withinWorkingHours ? 0 : 1) + 0.1 * candidate.secsFromRequest / SECS_PER_DAY;
+}
+
+/**
+  An immutable copy of everything needed to locate the free slots, so the
+  search can run in a worker thread while the resolver keeps changing.
+  The FreeBusy objects themselves are never modified once they are set on
+  the model, they are replaced when new data arrives.
+*/
+struct ConflictResolver::FreeSlotSearch {
+    SlotGrid grid;
+    QBitArray weekdays;
+    QVector<QPair<QTime, QTime>> allowedHours;
+    FreeSlotAlgorithm algorithm = SlotMatrix;
+    bool weighted = false;
+    QVector<KCalendarCore::FreeBusy::Ptr> freeBusy; //!< one per filtered attendee
+    QVector<int> weights; //!< the weight of each of freeBusy, SlotMatrix only
+    QVector<int> tentativeWeights; //!< the same for tentative busy periods
+    BusyRowCache busyCache; //!< the rows known so far, SlotMatrix only
+
+    QSharedPointer<QAtomicInt> generationCounter;
+    int generation = 0;
+
+    /**
+      Returns true if the resolver started another search since this one,
+      which makes the result of this one useless.
+    */
+    bool isCanceled() const
+    {
+        return generationCounter->loadRelaxed() != generation;
+    }
+};
+
+struct ConflictResolver::FreeSlotResult {
+    KCalendarCore::Period::List freeSlots;
+    BusyRowCache busyCache; //!< updated with the attendees of the search, SlotMatrix only
+    int cost = 0; //!< in WEIGHT_SCALE units of a role weight
+};
+
 void ConflictResolver::findAllFreeSlots()
 {
-    // Uses an O(p*n) (n number of attendees, p timeframe range / timeslot resolution ) algorithm to
-    // locate all free blocks in a given timeframe that match the search constraints.
-    // Does so by:
-    // 1. convert each attendees schedule for the timeframe into a bitarray according to
-    //    the time resolution, where each time slot has a value of 1 = busy, 0 = free.
-    // 2. align the arrays vertically, and sum the columns
-    // 3. the resulting summation indicates # of conflicts at each timeslot
-    // 4. locate contiguous timeslots with a values of 0. these are the free time blocks.
+    // Computes the free slots synchronously, and drops any search already
+    // running in the background.
+    mCalculateTimer.stop();
+    FreeSlotSearch search;
+    if (prepareFreeSlotSearch(search)) {
+        applyFreeSlotResult(computeFreeSlots(search));
+    } else {
+        resetBusyCache();
+    }
+}
+
+void ConflictResolver::startFreeSlotSearch()
+{
+    FreeSlotSearch search;
+    if (!prepareFreeSlotSearch(search)) {
+        resetBusyCache();
+        return;
+    }
+
+    auto watcher = new QFutureWatcher<FreeSlotResult>(this);
+    connect(watcher, &QFutureWatcher<FreeSlotResult>::finished, this, [this, watcher, generation = search.generation]() {
+        // Only the most recent search is of interest, all others were
+        // started with outdated constraints.
+        if (generation == mSearchGeneration->loadRelaxed()) {
+            applyFreeSlotResult(watcher->result());
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([search]() {
+        return computeFreeSlots(search);
+    }));
+}
+
+bool ConflictResolver::prepareFreeSlotSearch(FreeSlotSearch &search)
+{
+    // Any search started before works on outdated data now.
+    search.generationCounter = mSearchGeneration;
+    search.generation = mSearchGeneration->fetchAndAddRelaxed(1) + 1;
 
     // define these locally for readability
     const QDateTime begin = mTimeframeConstraint.start();
@@ -238,192 +649,300 @@ void ConflictResolver::findAllFreeSlots()
     // calculate the length of the timeframe in terms of the amount of timeslots.
     // Example: 1 week timeframe, with resolution of 15 minutes
     //          1 week = 10080 minutes / 15 = 672 15 min timeslots
-    //          So, the array would have a length of 672
+    //          So, the bitmaps would have a length of 672
     const int range = begin.secsTo(end) / mSlotResolutionSeconds;
     if (range <= 0) {
         qCWarning(INCIDENCEEDITOR_LOG) << "free slot calculation: invalid range. range( " << begin.secsTo(end) << ") / mSlotResolutionSeconds("
                                        << mSlotResolutionSeconds << ") = " << range;
-        return;
+        return false;
     }
 
     qCDebug(INCIDENCEEDITOR_LOG) << "from " << begin << " to " << end << "; mSlotResolutionSeconds = " << mSlotResolutionSeconds << "; range = " << range;
     // filter out attendees for which we don't have FB data
-    // and which don't match the mandatory role constraint
-    QList<KCalendarCore::FreeBusy::Ptr> filteredFBItems;
+    // and which don't match the mandatory role constraint,
+    // or whose conflicts weigh nothing
     for (int i = 0; i < mFBModel->rowCount(); ++i) {
         QModelIndex index = mFBModel->index(i);
         auto attendee = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        if (!matchesRoleConstraint(attendee)) {
+        int weight = 1;
+        int tentativeWeight = 1;
+        if (mWeightedConflicts) {
+            const int conflictWeight = roleWeight(attendee.role());
+            weight = conflictWeight * WEIGHT_SCALE;
+            tentativeWeight = conflictWeight * mTentativeWeightPercent * WEIGHT_SCALE / 100;
+            if (weight == 0 && tentativeWeight == 0) {
+                continue;
+            }
+        } else if (!matchesRoleConstraint(attendee)) {
             continue;
         }
         auto freebusy = mFBModel->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
         if (freebusy) {
-            filteredFBItems << freebusy;
+            search.freeBusy << freebusy;
+            search.weights << weight;
+            search.tentativeWeights << tentativeWeight;
         }
     }
 
     // now we know the number of attendees we are calculating for
-    const int number_attendees = filteredFBItems.size();
+    const int number_attendees = search.freeBusy.size();
     if (number_attendees <= 0) {
         qCDebug(INCIDENCEEDITOR_LOG) << "no attendees match search criteria";
-        return;
+        return false;
     }
     qCDebug(INCIDENCEEDITOR_LOG) << "num attendees: " << number_attendees;
-    // this is a 2 dimensional array where the rows are attendees
-    // and the columns are 0 or 1 denoting free or busy respectively.
-    QVector<QVector<int>> fbTable;
-
-    // Explanation of the following loop:
-    // iterate: through each attendee
-    //   allocate: an array of length <range> and fill it with 0s
-    //   iterate: through each attendee's busy period
-    //     if: the period lies inside our timeframe
-    //     then:
-    //       calculate the array index within the timeframe range of the beginning of the busy period
-    //       fill from that index until the period ends with a 1, representing busy
-    //     fi
-    //   etareti
-    // append the allocated array to <fbTable>
-    // etareti
-    for (const KCalendarCore::FreeBusy::Ptr &currentFB : qAsConst(filteredFBItems)) {
-        Q_ASSERT(currentFB); // sanity check
-        const KCalendarCore::Period::List busyPeriods = currentFB->busyPeriods();
-        QVector<int> fbArray(range);
-        fbArray.fill(0); // initialize to zero
-        for (const auto &period : busyPeriods) {
-            if (period.end() >= begin && period.start() <= end) {
-                int start_index = -1; // Initialize it to an invalid value.
-                int duration = -1; // Initialize it to an invalid value.
-                // case1: the period is completely in our timeframe
-                if (period.end() <= end && period.start() >= begin) {
-                    start_index = begin.secsTo(period.start()) / mSlotResolutionSeconds;
-                    duration = period.start().secsTo(period.end()) / mSlotResolutionSeconds;
-                    duration -= 1; // vector starts at 0
-                    // case2: the period begins before our timeframe begins
-                } else if (period.start() <= begin && period.end() <= end) {
-                    start_index = 0;
-                    duration = (begin.secsTo(period.end()) / mSlotResolutionSeconds) - 1;
-                    // case3: the period ends after our timeframe ends
-                } else if (period.end() >= end && period.start() >= begin) {
-                    start_index = begin.secsTo(period.start()) / mSlotResolutionSeconds;
-                    duration = range - start_index - 1;
-                    // case4: case2+case3: our timeframe is inside the period
-                } else if (period.start() <= begin && period.end() >= end) {
-                    start_index = 0;
-                    duration = range - 1;
-                } else {
-                    // QT5
-                    // qCCritical(INCIDENCEEDITOR_LOG) << "impossible condition reached" << period.start() << period.end();
-                }
-                //      qCDebug(INCIDENCEEDITOR_LOG) << start_index << "+" << duration << "="
-                //               << start_index + duration << "<=" << range;
-                Q_ASSERT((start_index + duration) < range); // sanity check
-                for (int i = start_index; i <= start_index + duration; ++i) {
-                    fbArray[i] = 1;
-                }
-            }
+
+    search.grid = SlotGrid(begin, end, mSlotResolutionSeconds);
+    search.weekdays = mWeekdays;
+    search.allowedHours = mAllowedHours;
+    search.weighted = mWeightedConflicts;
+    // Only the matrix can sum up weights
+    search.algorithm = mWeightedConflicts ? SlotMatrix : mFreeSlotAlgorithm;
+    if (search.algorithm == SlotMatrix) {
+        // Reuse the rows of the previous search, unless the grid changed.
+        // Only weighing conflicts needs the counts kept up to date.
+        if (mBusyCache.grid() == search.grid && mBusyCache.isWeighted() == search.weighted) {
+            search.busyCache = mBusyCache;
+        } else {
+            search.busyCache = BusyRowCache(search.grid, search.weighted);
         }
-        Q_ASSERT(fbArray.size() == range); // sanity check
-        fbTable.append(fbArray);
     }
+    return true;
+}
 
-    Q_ASSERT(fbTable.size() == number_attendees);
+ConflictResolver::FreeSlotResult ConflictResolver::computeFreeSlots(const FreeSlotSearch &search)
+{
+    // Locates all free blocks in a given timeframe that match the search constraints.
+    // The timeframe is divided into timeslots of the search resolution, the busy
+    // periods of all attendees and the disallowed weekdays are mapped onto those
+    // timeslots, and every run of timeslots nobody is busy in is a free block.
+    // See freeSlotsFromMatrix() and freeSlotsFromIntervals() for the two ways
+    // of doing so.
+    FreeSlotResult result;
+    QVector<QPair<int, int>> freeBlocks;
+    if (search.algorithm == IntervalSweep) {
+        freeBlocks = freeSlotsFromIntervals(search);
+    } else {
+        result.busyCache = search.busyCache;
+        freeBlocks = freeSlotsFromMatrix(search, result.busyCache, &result.cost);
+    }
 
-    // Now, create another array to represent the allowed weekdays constraints
-    // All days which are not allowed, will be marked as busy
-    QVector<int> fbArray(range);
-    fbArray.fill(0); // initialize to zero
-    for (int slot = 0; slot < fbArray.size(); ++slot) {
-        const QDateTime dateTime = begin.addSecs(slot * mSlotResolutionSeconds);
-        const int dayOfWeek = dateTime.date().dayOfWeek() - 1; // bitarray is 0 indexed
-        if (!mWeekdays[dayOfWeek]) {
-            fbArray[slot] = 1;
-        }
+    if (search.isCanceled()) {
+        return {};
+    }
+    KCalendarCore::Period::List &freeSlots = result.freeSlots;
+    freeSlots.reserve(freeBlocks.size());
+    for (const auto &block : freeBlocks) {
+        // convert from our timeslot interval back into to normal seconds
+        // then calculate the date times of the free block based on
+        // our initial timeframe
+        const QDateTime freeBegin = search.grid.slotStart(block.first);
+        const QDateTime freeEnd = search.grid.slotStart(block.second);
+        // push the free block onto the list
+        freeSlots << KCalendarCore::Period(freeBegin, freeEnd);
     }
-    fbTable.append(fbArray);
+    return result;
+}
 
-    // Create the composite array that will hold the sums for
-    // each 15 minute timeslot
-    QVector<int> summed(range);
-    summed.fill(0); // initialize to zero
+QVector<QPair<int, int>> ConflictResolver::freeSlotsFromMatrix(const FreeSlotSearch &search, BusyRowCache &busyCache, int *cost)
+{
+    // Uses an O(p*n/64) (n number of attendees, p timeframe range / timeslot resolution ) algorithm:
+    // 1. convert each attendees schedule for the timeframe into a bitmap according to
+    //    the time resolution, where each time slot has a value of 1 = busy, 0 = free.
+    //    Attendees whose free/busy data did not change since the last search reuse
+    //    the bitmap of that search.
+    // 2. OR the bitmaps of all attendees together, 64 timeslots at a time. This is
+    //    only redone when attendees came or went.
+    //    When weighing conflicts, a running count of the weights of the busy attendees
+    //    is kept for each timeslot instead, adding only the bitmaps of attendees that
+    //    came and subtracting the ones of attendees that went.
+    // 3. a set bit means at least one conflict in that timeslot
+    // 4. locate contiguous timeslots which are not set and not excluded by the
+    //    weekday constraint. these are the free time blocks. When weighing conflicts,
+    //    the timeslots with the lowest count are taken instead.
+    const int range = search.grid.range();
+    Q_ASSERT(busyCache.range() == range);
 
-    // Sum the columns of the table
-    for (int i = 0; i < fbTable.size(); ++i) {
-        for (int j = 0; j < range; ++j) {
-            summed[j] += fbTable[i][j];
+    busyCache.beginUpdate();
+    for (int i = 0; i < search.freeBusy.size(); ++i) {
+        if (search.isCanceled()) {
+            return {};
         }
+        busyCache.addFreeBusy(search.freeBusy.at(i), search.weights.at(i), search.tentativeWeights.at(i));
     }
+    busyCache.endUpdate();
 
-    // Finally, iterate through the composite array locating contiguous free timeslots
-    int free_count = 0;
-    bool free_found = false;
-    mAvailableSlots.clear();
-    for (int i = 0; i < range; ++i) {
-        // free timeslot encountered, increment counter
-        if (summed[i] == 0) {
-            ++free_count;
-        }
-        if (summed[i] != 0 || (i == (range - 1) && summed[i] == 0)) {
-            // current slot is not free, so push the previous free blocks
-            // OR we are in the last slot and it is free
-            if (free_count > 0) {
-                int free_start_i; // start index of the free block
-                int free_end_i; // end index of the free block
-                if (summed[i] == 0) {
-                    // special case: we are on the last slot and it is free
-                    //               so we want to include this slot in the free block
-                    free_start_i = i - free_count + 1; // add one, to set us back inside the array because
-                    // free_count was incremented already this iteration
-                    free_end_i = i + 1; // add one to compensate for the fact that the array is 0 indexed
-                } else {
-                    free_start_i = i - free_count;
-                    free_end_i = i - 1 + 1; // add one to compensate for the fact that the array is 0 indexed
-                    // compiler will optimize out the -1+1, but I leave it here to make the reasoning apparent.
-                }
-                // convert from our timeslot interval back into to normal seconds
-                // then calculate the date times of the free block based on
-                // our initial timeframe
-                const QDateTime freeBegin = begin.addSecs(free_start_i * mSlotResolutionSeconds);
-                const QDateTime freeEnd = freeBegin.addSecs((free_end_i - free_start_i) * mSlotResolutionSeconds);
-                // push the free block onto the list
-                mAvailableSlots << KCalendarCore::Period(freeBegin, freeEnd);
-                free_count = 0;
-                if (!free_found) {
-                    free_found = true;
-                }
-            }
+    // Now, create a bitmap to represent the allowed weekdays and hours constraints
+    // All times which are not allowed, will be marked as busy
+    BusyBitmap disallowedSlots(range);
+    const QVector<QPair<int, int>> disallowed = disallowedSlotRanges(search);
+    for (const auto &block : disallowed) {
+        disallowedSlots.setRange(block.first, block.second - block.first);
+    }
+
+    if (search.isCanceled()) {
+        return {};
+    }
+
+    BusyBitmap busy;
+    *cost = 0;
+    if (search.weighted) {
+        // The cheapest of the allowed timeslots are the ones to offer
+        const QVector<int> counts = busyCache.busyCounts();
+        int first = disallowedSlots.nextClearBit(0);
+        if (first >= range) {
+            // no timeslot is allowed at all
+            return {};
         }
+        int minimum = counts.at(first);
+        while (first < range) {
+            const int last = disallowedSlots.nextSetBit(first);
+            minimum = qMin(minimum, *std::min_element(counts.constBegin() + first, counts.constBegin() + last));
+            first = disallowedSlots.nextClearBit(last);
+        }
+        *cost = minimum;
+        busy = BusyBitmap::fromCounts(counts, minimum);
+    } else {
+        busy = busyCache.busySlots();
     }
-    if (free_found) {
-        Q_EMIT freeSlotsAvailable(mAvailableSlots);
+    busy.unite(disallowedSlots);
+
+    // Finally, scan the composite bitmap for contiguous free timeslots
+    QVector<QPair<int, int>> freeBlocks;
+    int free_start_i = busy.nextClearBit(0);
+    while (free_start_i < range) {
+        const int free_end_i = busy.nextSetBit(free_start_i);
+        freeBlocks.append(qMakePair(free_start_i, free_end_i));
+        free_start_i = busy.nextClearBit(free_end_i);
     }
 #if 0
-    //DEBUG, dump the arrays. very helpful for debugging
+    //DEBUG, dump the counts. very helpful for debugging
     QTextStream dump(stdout);
-    dump << "    ";
+    const QVector<int> counts = busyCache.busyCounts();
     dump.setFieldWidth(3);
     for (int i = 0; i < range; ++i) {   // header
         dump << i;
     }
-    dump.setFieldWidth(1);
-    dump << "\n\n";
-    for (int i = 0; i < number_attendees; ++i) {
-        dump.setFieldWidth(1);
-        dump << i << ":  ";
-        dump.setFieldWidth(3);
-        for (int j = 0; j < range; ++j) {
-            dump << fbTable[i][j];
-        }
-        dump << "\n\n";
+    dump << "\n";
+    for (int i = 0; i < range; ++i) {
+        dump << counts[i];
     }
-    dump.setFieldWidth(1);
-    dump << "    ";
-    dump.setFieldWidth(3);
+    dump << "\n";
     for (int i = 0; i < range; ++i) {
-        dump << summed[i];
+        dump << int(busy.testBit(i));
     }
     dump << "\n";
 #endif
+    return freeBlocks;
+}
+
+QVector<QPair<int, int>> ConflictResolver::freeSlotsFromIntervals(const FreeSlotSearch &search)
+{
+    // Uses an O(P log P) (P number of busy periods plus days in the timeframe) algorithm:
+    // 1. map every busy period onto a [first, last) range of timeslots, exactly like
+    //    the matrix does, and add the ranges excluded by the weekday and hour constraints.
+    // 2. sort the ranges by their first timeslot.
+    // 3. sweep over them; every gap between the ranges covered so far and the
+    //    next range is a free block.
+    // Only the ranges are stored, so the resolution does not affect the cost.
+    const int range = search.grid.range();
+    QVector<QPair<int, int>> busyBlocks;
+
+    for (const KCalendarCore::FreeBusy::Ptr &freeBusy : search.freeBusy) {
+        if (search.isCanceled()) {
+            return {};
+        }
+        const KCalendarCore::Period::List busyPeriods = freeBusy->busyPeriods();
+        for (const auto &period : busyPeriods) {
+            int start_index;
+            int count;
+            // empty ranges do not block anything, but would split the free block they are in
+            if (search.grid.slotSpan(period, &start_index, &count) && count > 0) {
+                busyBlocks.append(qMakePair(start_index, start_index + count));
+            }
+        }
+    }
+
+    busyBlocks += disallowedSlotRanges(search);
+
+    if (search.isCanceled()) {
+        return {};
+    }
+
+    std::sort(busyBlocks.begin(), busyBlocks.end());
+
+    QVector<QPair<int, int>> freeBlocks;
+    int free_start_i = 0;
+    for (const auto &block : qAsConst(busyBlocks)) {
+        if (block.first > free_start_i) {
+            freeBlocks.append(qMakePair(free_start_i, block.first));
+        }
+        free_start_i = qMax(free_start_i, block.second);
+    }
+    if (free_start_i < range) {
+        freeBlocks.append(qMakePair(free_start_i, range));
+    }
+    return freeBlocks;
+}
+
+QVector<QPair<int, int>> ConflictResolver::disallowedSlotRanges(const FreeSlotSearch &search)
+{
+    // A timeslot belongs to the day its start lies in. The grid knows the
+    // timeslots of each day from its table of UTC offsets, so neither the
+    // date of every timeslot nor the boundaries of every day have to go
+    // through the time zone, and DST transitions still shorten or lengthen
+    // the days as they should.
+    QVector<QPair<int, int>> disallowed;
+    const QVector<SlotGrid::Day> days = search.grid.days();
+    for (const SlotGrid::Day &day : days) {
+        const int weekday = day.date.dayOfWeek() - 1; // bitarray is 0 indexed
+        if (!search.weekdays[weekday]) {
+            disallowed.append(qMakePair(day.first, day.last));
+            continue;
+        }
+
+        const QPair<QTime, QTime> &hours = search.allowedHours.at(weekday);
+        if (!hours.first.isValid() || !hours.second.isValid()) {
+            continue;
+        }
+        // Only the timeslots lying completely within the allowed hours remain
+        const int allowedFirst = qBound(qint64(day.first), search.grid.firstSlotStartingAt(day.date, hours.first), qint64(day.last));
+        const int allowedLast = qBound(qint64(allowedFirst), search.grid.lastSlotEndingAt(day.date, hours.second), qint64(day.last));
+        if (day.first < allowedFirst) {
+            disallowed.append(qMakePair(day.first, allowedFirst));
+        }
+        if (allowedLast < day.last) {
+            disallowed.append(qMakePair(allowedLast, day.last));
+        }
+    }
+    return disallowed;
+}
+
+void ConflictResolver::applyFreeSlotResult(const FreeSlotResult &result)
+{
+    if (result.busyCache.range() > 0) {
+        const bool countsChanged = !(mBusyCache.grid() == result.busyCache.grid()) || mBusyCache.isWeighted() != result.busyCache.isWeighted()
+            || mBusyCache.revision() != result.busyCache.revision();
+        mBusyCache = result.busyCache;
+        if (countsChanged) {
+            Q_EMIT busyCountsChanged();
+        }
+    } else {
+        resetBusyCache();
+    }
+    mAvailableSlots = result.freeSlots;
+    mAvailableSlotsCost = double(result.cost) / WEIGHT_SCALE;
+    if (!mAvailableSlots.isEmpty()) {
+        Q_EMIT freeSlotsAvailable(mAvailableSlots);
+    }
+}
+
+void ConflictResolver::resetBusyCache()
+{
+    if (mBusyCache.range() > 0) {
+        mBusyCache = BusyRowCache();
+        Q_EMIT busyCountsChanged();
+    }
 }
 
 void ConflictResolver::calculateConflicts()
@@ -433,6 +952,8 @@ void ConflictResolver::calculateConflicts()
     const int count = tryDate(start, end);
     Q_EMIT conflictsDetected(count);
 
+    // The constraints changed, the result of a search still running is outdated.
+    mSearchGeneration->ref();
     if (!mCalculateTimer.isActive()) {
         mCalculateTimer.start(0);
     }
@@ -444,6 +965,19 @@ void ConflictResolver::setAllowedWeekdays(const QBitArray &weekdays)
     calculateConflicts();
 }
 
+void ConflictResolver::setAllowedHours(int weekday, const QTime &start, const QTime &end)
+{
+    Q_ASSERT(weekday >= 0 && weekday < 7);
+    mAllowedHours[weekday] = qMakePair(start, end);
+    calculateConflicts();
+}
+
+void ConflictResolver::setAllowedHours(const QTime &start, const QTime &end)
+{
+    mAllowedHours.fill(qMakePair(start, end));
+    calculateConflicts();
+}
+
 void ConflictResolver::setMandatoryRoles(const QSet<KCalendarCore::Attendee::Role> &roles)
 {
     mMandatoryRoles = roles;
@@ -455,11 +989,69 @@ bool ConflictResolver::matchesRoleConstraint(const KCalendarCore::Attendee &atte
     return mMandatoryRoles.contains(attendee.role());
 }
 
+void ConflictResolver::setWeightedConflicts(bool weighted)
+{
+    mWeightedConflicts = weighted;
+    calculateConflicts();
+}
+
+bool ConflictResolver::weightedConflicts() const
+{
+    return mWeightedConflicts;
+}
+
+void ConflictResolver::setRoleWeight(KCalendarCore::Attendee::Role role, int weight)
+{
+    mRoleWeights.insert(role, weight);
+    calculateConflicts();
+}
+
+int ConflictResolver::roleWeight(KCalendarCore::Attendee::Role role) const
+{
+    return mRoleWeights.value(role, 0);
+}
+
+void ConflictResolver::setTentativeWeightPercent(int percent)
+{
+    mTentativeWeightPercent = percent;
+    calculateConflicts();
+}
+
+int ConflictResolver::tentativeWeightPercent() const
+{
+    return mTentativeWeightPercent;
+}
+
+double ConflictResolver::availableSlotsCost() const
+{
+    return mAvailableSlotsCost;
+}
+
+QVector<int> ConflictResolver::busyCounts() const
+{
+    return mBusyCache.busyCounts();
+}
+
+SlotGrid ConflictResolver::busyCountsGrid() const
+{
+    return mBusyCache.grid();
+}
+
 KCalendarCore::Period::List ConflictResolver::availableSlots() const
 {
     return mAvailableSlots;
 }
 
+void ConflictResolver::setFreeSlotAlgorithm(FreeSlotAlgorithm algorithm)
+{
+    mFreeSlotAlgorithm = algorithm;
+}
+
+ConflictResolver::FreeSlotAlgorithm ConflictResolver::freeSlotAlgorithm() const
+{
+    return mFreeSlotAlgorithm;
+}
+
 void ConflictResolver::setResolution(int seconds)
 {
     mSlotResolutionSeconds = seconds;
@@ -9,12 +9,22 @@
 
 #pragma once
 
+#include "busyintervalindex.h"
+#include "busyrowcache.h"
 #include "incidenceeditor_export.h"
 #include <CalendarSupport/FreeBusyItem>
 
+#include <QAtomicInt>
 #include <QBitArray>
+#include <QHash>
+#include <QPair>
 #include <QSet>
+#include <QSharedPointer>
+#include <QTime>
 #include <QTimer>
+#include <QVector>
+
+#include <functional>
 
 namespace CalendarSupport
 {
@@ -35,10 +45,40 @@ class INCIDENCEEDITOR_EXPORT ConflictResolver : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * The algorithm used by findAllFreeSlots() to locate free slots.
+     * Both produce the same slots.
+     */
+    enum FreeSlotAlgorithm {
+        SlotMatrix, ///< One busy bitmap per attendee, cost grows with timeframe / resolution
+        IntervalSweep ///< Sorted busy intervals, cost grows with the number of busy periods only
+    };
+
+    /**
+     * A candidate slot found by rankedFreeSlots().
+     */
+    struct SlotCandidate {
+        KCalendarCore::Period period;
+        /// The number of attendees without a mandatory role who are busy during the slot
+        int busyOptionalAttendees = 0;
+        /// The seconds between the requested start and the start of the slot
+        qint64 secsFromRequest = 0;
+        /// Whether the slot lies within the working hours, see setWorkingHours()
+        bool withinWorkingHours = true;
+        /// The cost assigned by the slot cost function, lower is better
+        double cost = 0;
+    };
+
+    /**
+     * Assigns a cost to a candidate slot, see setSlotCostFunction().
+     */
+    using SlotCostFunction = std::function<double(const SlotCandidate &candidate)>;
+
     /**
      * @param parentWidget is passed to Akonadi when fetching free/busy data.
      */
     explicit ConflictResolver(QWidget *parentWidget, QObject *parent = nullptr);
+    ~ConflictResolver() override;
 
     /**
      *  Add an attendee
@@ -48,6 +88,13 @@ public:
     void insertAttendee(const KCalendarCore::Attendee &attendee);
 
     void insertAttendee(const CalendarSupport::FreeBusyItem::Ptr &freebusy);
+
+    /**
+     * Adds all @p attendees not in the resolver yet, checking for the ones
+     * already present in one pass instead of once per attendee.
+     */
+    void insertAttendees(const KCalendarCore::Attendee::List &attendees);
+
     /**
      * Removes an attendee
      * The attendee will no longer be considered when
@@ -56,6 +103,19 @@ public:
 
     void removeAttendee(const KCalendarCore::Attendee &attendee);
 
+    /**
+     * Removes all @p attendees, recalculating the conflicts only once.
+     */
+    void removeAttendees(const KCalendarCore::Attendee::List &attendees);
+
+    /**
+     * Makes @p attendees the attendees of the resolver. Only the attendees
+     * not in the resolver yet are added and have their free/busy data
+     * fetched, the ones no longer in @p attendees are removed, and the
+     * conflicts are recalculated at most once.
+     */
+    void setAttendees(const KCalendarCore::Attendee::List &attendees);
+
     /**
      * Clear all attendees
      */
@@ -75,6 +135,20 @@ public:
      */
     void setAllowedWeekdays(const QBitArray &weekdays);
 
+    /**
+     * Constrain the free time slot search on the weekday @p weekday
+     * (0=Monday, as in setAllowedWeekdays()) to the time slots lying
+     * completely between @p start and @p end. Invalid times allow the
+     * whole day, which is the default.
+     */
+    void setAllowedHours(int weekday, const QTime &start, const QTime &end);
+
+    /**
+     * Constrain the free time slot search on all weekdays to the time slots
+     * lying completely between @p start and @p end.
+     */
+    void setAllowedHours(const QTime &start, const QTime &end);
+
     /**
      * Constrain the free time slot search to the set participant roles.
      * Mandatory roles are considered the minimum required to attend
@@ -85,6 +159,52 @@ public:
      */
     void setMandatoryRoles(const QSet<KCalendarCore::Attendee::Role> &roles);
 
+    /**
+     * Switches findAllFreeSlots() from requiring every attendee of a
+     * mandatory role to be free, the default, to weighing the conflicts.
+     * In weighted mode every attendee with free/busy information counts with
+     * the weight of their role, scaled by the tentative weight percentage
+     * where they are only tentatively busy. The slots with the least summed
+     * weight are returned, so there are slots even if nobody is free at
+     * the same time.
+     * Weighted mode always uses the SlotMatrix algorithm.
+     * @see availableSlotsCost
+     */
+    void setWeightedConflicts(bool weighted);
+    Q_REQUIRED_RESULT bool weightedConflicts() const;
+
+    /**
+     * Sets the weight of a conflict with an attendee of @p role.
+     * Defaults are 8 for chairs, 6 for required and 2 for optional
+     * participants, and 0 for non-participants.
+     */
+    void setRoleWeight(KCalendarCore::Attendee::Role role, int weight);
+    Q_REQUIRED_RESULT int roleWeight(KCalendarCore::Attendee::Role role) const;
+
+    /**
+     * Sets the weight of a tentative conflict in percent of the weight of
+     * a conflict. Default is 50.
+     */
+    void setTentativeWeightPercent(int percent);
+    Q_REQUIRED_RESULT int tentativeWeightPercent() const;
+
+    /**
+     * Returns the summed weight of the conflicts in each of the
+     * availableSlots(), which is 0 unless conflicts are weighted.
+     */
+    Q_REQUIRED_RESULT double availableSlotsCost() const;
+
+    /**
+     * Returns for each slot of busyCountsGrid() the summed weight of the
+     * attendees considered by the last free slot search being busy in it,
+     * which is their number unless conflicts are weighted. Weighted counts
+     * are given in hundredths of a role weight.
+     * Empty unless the last search used the SlotMatrix algorithm.
+     * @see busyCountsChanged
+     */
+    Q_REQUIRED_RESULT QVector<int> busyCounts() const;
+    Q_REQUIRED_RESULT SlotGrid busyCountsGrid() const;
+
     /**
      * Returns a list of date time ranges that conform to the
      * search constraints.
@@ -99,8 +219,65 @@ public:
     */
     Q_REQUIRED_RESULT bool findFreeSlot(const KCalendarCore::Period &dateTimeRange);
 
+    /**
+     * Returns up to @p count slots of the same size as @p dateTimeRange
+     * within the search horizon, best first, in which all attendees of a
+     * mandatory role are free. Slots are tried at the resolution set with
+     * setResolution(), starting at the requested start but never in the past.
+     * Slots of equal cost are ordered by time.
+     *
+     * Of the slots only differing in their distance from the request, only
+     * the earliest @p count ones are rated, see setSlotCostFunction().
+     * @see setSlotCostFunction
+     */
+    Q_REQUIRED_RESULT QVector<SlotCandidate> rankedFreeSlots(const KCalendarCore::Period &dateTimeRange, int count);
+
+    /**
+     * Limits findFreeSlot() and rankedFreeSlots() to slots starting at most
+     * @p days days after the requested start. Default is 365 days, negative
+     * values are ignored.
+     */
+    void setSearchHorizon(int days);
+    Q_REQUIRED_RESULT int searchHorizon() const;
+
+    /**
+     * Sets the daily working hours rankedFreeSlots() rates slots against.
+     * An @p end of midnight is the end of the day. Working hours ending
+     * before they start are ignored. By default all hours are working hours.
+     */
+    void setWorkingHours(const QTime &start, const QTime &end);
+
+    /**
+     * Sets the function rating the slots found by rankedFreeSlots().
+     * A null function restores defaultSlotCost(). Moving a slot later without
+     * changing anything else about it must not lower its cost.
+     */
+    void setSlotCostFunction(const SlotCostFunction &function);
+
+    /**
+     * Every optional attendee being busy costs 1, as does a slot outside of
+     * the working hours; every day between the requested and the found slot
+     * costs 0.1.
+     */
+    Q_REQUIRED_RESULT static double defaultSlotCost(const SlotCandidate &candidate);
+
+    /**
+     * Selects the algorithm used to locate free slots.
+     * Default is SlotMatrix. IntervalSweep is preferable for fine
+     * resolutions or long timeframes with few busy periods.
+     */
+    void setFreeSlotAlgorithm(FreeSlotAlgorithm algorithm);
+    Q_REQUIRED_RESULT FreeSlotAlgorithm freeSlotAlgorithm() const;
+
     CalendarSupport::FreeBusyItemModel *model() const;
 
+    /**
+     * Returns the busy periods of @p freeBusy compiled into an index. The
+     * index is shared with the conflict detection and kept while @p freeBusy
+     * is in the model(), so it is only built once for every attendee.
+     */
+    Q_REQUIRED_RESULT BusyIntervalIndex busyIntervals(const KCalendarCore::FreeBusy::Ptr &freeBusy);
+
 Q_SIGNALS:
     /**
      * Emitted when the user changes the start and end dateTimes
@@ -119,6 +296,11 @@ Q_SIGNALS:
      */
     void freeSlotsAvailable(const KCalendarCore::Period::List &);
 
+    /**
+     * Emitted when busyCounts() changed.
+     */
+    void busyCountsChanged();
+
 public Q_SLOTS:
     /**
      * Set the timeframe constraints
@@ -140,6 +322,20 @@ public Q_SLOTS:
     void setResolution(int seconds);
 
 private:
+    /**
+     * Adds the free/busy item of @p attendee to the free/busy model, filled
+     * with the data of the free/busy cache. While that data is fresh, or
+     * while the cache is prefetching it, it is not fetched again. Returns
+     * whether there was cached data.
+     */
+    bool addFreeBusyItem(const KCalendarCore::Attendee &attendee);
+
+    /**
+     * Stores the fetched free/busy data of the rows @p first to @p last of
+     * the free/busy model in the free/busy cache.
+     */
+    void cacheFreeBusy(int first, int last);
+
     /**
       Checks whether the slot specified by (tryFrom, tryTo) matches the
       search constraints. If yes, return true. The return value is the
@@ -150,13 +346,28 @@ private:
     int tryDate(QDateTime &tryFrom, QDateTime &tryTo);
 
     /**
-      Checks whether the slot specified by (tryFrom, tryTo) is available
-      for the participant with specified fb. If yes, return true. If
-      not, return false and change (tryFrom, tryTo) to contain the next
-      possible slot for this participant (not necessarily a slot that is
-      available for all participants).
+      Returns the busy interval index of every attendee with free/busy
+      information passing the mandatory role constraint. The ones of the
+      other attendees are stored in @p optionalIndexes, if given.
     */
-    bool tryDate(const KCalendarCore::FreeBusy::Ptr &fb, QDateTime &tryFrom, QDateTime &tryTo);
+    QVector<BusyIntervalIndex> attendeeIntervalIndexes(QVector<BusyIntervalIndex> *optionalIndexes = nullptr);
+
+    /**
+      Returns the working hours of the day of @p dateTime.
+    */
+    QPair<QDateTime, QDateTime> workingHoursOf(const QDateTime &dateTime) const;
+
+    /**
+      Returns whether @p period lies within the working hours.
+    */
+    bool isWithinWorkingHours(const KCalendarCore::Period &period) const;
+
+    /**
+      Returns the earliest start after @p start at which a slot of
+      @p duration milliseconds may lie within the working hours differently
+      than the one starting at @p start, in milliseconds since the epoch.
+    */
+    qint64 nextWorkingHoursChange(const QDateTime &start, qint64 duration) const;
 
     /**
      * Checks whether the supplied attendee passes the
@@ -167,6 +378,45 @@ private:
 
     void calculateConflicts();
 
+    struct FreeSlotSearch;
+    struct FreeSlotResult;
+
+    /**
+     * Starts locating the free slots in a worker thread. freeSlotsAvailable()
+     * is emitted once the search finished, unless the constraints changed
+     * in the meantime.
+     */
+    void startFreeSlotSearch();
+
+    /**
+     * Copies the current constraints and the free/busy data of the attendees
+     * matching them into @p search. Returns false if there is nothing to search.
+     */
+    bool prepareFreeSlotSearch(FreeSlotSearch &search);
+
+    /**
+     * Returns the free slots for @p search. Thread safe, only works on @p search.
+     */
+    static FreeSlotResult computeFreeSlots(const FreeSlotSearch &search);
+
+    /**
+     * Both return the free blocks of the timeframe of @p search as a sorted
+     * list of [first, last) slot indexes. The matrix version brings
+     * @p busyCache up to date with the attendees of @p search on the way,
+     * and stores the summed weight of the conflicts in the blocks in @p cost.
+     */
+    static QVector<QPair<int, int>> freeSlotsFromMatrix(const FreeSlotSearch &search, BusyRowCache &busyCache, int *cost);
+    static QVector<QPair<int, int>> freeSlotsFromIntervals(const FreeSlotSearch &search);
+
+    /**
+     * Returns the timeslots of @p search excluded by the weekday and hour
+     * constraints as a sorted list of [first, last) slot indexes.
+     */
+    static QVector<QPair<int, int>> disallowedSlotRanges(const FreeSlotSearch &search);
+
+    void applyFreeSlotResult(const FreeSlotResult &result);
+    void resetBusyCache();
+
     KCalendarCore::Period mTimeframeConstraint; //!< the datetime range for outside of which
     // free slots won't be searched.
     KCalendarCore::Period::List mAvailableSlots;
@@ -177,12 +427,40 @@ private:
 
     CalendarSupport::FreeBusyItemModel *mFBModel = nullptr;
     QWidget *mParentWidget = nullptr;
+    QHash<QString, QWeakPointer<KCalendarCore::FreeBusy>> mCachedFreeBusy; //!< the data taken from the free/busy cache, by email
+    QMultiHash<QString, QWeakPointer<CalendarSupport::FreeBusyItem>> mPrefetchedItems; //!< the items waiting for FreeBusyCache::prefetch(), by email
 
     QSet<KCalendarCore::Attendee::Role> mMandatoryRoles;
     QBitArray mWeekdays; //!< a 7 bit array indicating the allowed days
     //(bit 0 = Monday, value 1 = allowed).
+    QVector<QPair<QTime, QTime>> mAllowedHours; //!< the allowed hours of each weekday
 
     int mSlotResolutionSeconds;
+    FreeSlotAlgorithm mFreeSlotAlgorithm = SlotMatrix;
+
+    /// Bumped whenever a search is started or the constraints change,
+    /// so searches running in the background know they are outdated.
+    QSharedPointer<QAtomicInt> mSearchGeneration;
+
+    bool mWeightedConflicts = false;
+    QHash<KCalendarCore::Attendee::Role, int> mRoleWeights;
+    int mTentativeWeightPercent = 50;
+    double mAvailableSlotsCost = 0;
+
+    int mSearchHorizonDays = 365;
+    QTime mWorkingHoursStart;
+    QTime mWorkingHoursEnd;
+    SlotCostFunction mSlotCostFunction;
+
+    /// The busy rows of the attendees of the last SlotMatrix search.
+    BusyRowCache mBusyCache;
+
+    struct IntervalIndexEntry {
+        KCalendarCore::FreeBusy::Ptr freeBusy; //!< keeps the key alive
+        BusyIntervalIndex index;
+    };
+    /// The compiled busy periods of the attendees, see attendeeIntervalIndexes().
+    QHash<const KCalendarCore::FreeBusy *, IntervalIndexEntry> mIntervalIndexes;
 };
 }
 
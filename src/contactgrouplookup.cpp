@@ -0,0 +1,136 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "contactgrouplookup.h"
+
+#include <AkonadiCore/ItemFetchScope>
+#include <AkonadiCore/ItemSearchJob>
+#include <AkonadiCore/SearchQuery>
+
+#include <QCoreApplication>
+
+using namespace IncidenceEditorNG;
+
+static const int DEBOUNCE_MSECS = 150;
+static const int CACHED_NAMES = 512;
+
+Q_GLOBAL_STATIC(ContactGroupLookup, sLookup)
+
+ContactGroupLookup *ContactGroupLookup::instance()
+{
+    return sLookup;
+}
+
+ContactGroupLookup::ContactGroupLookup(QObject *parent)
+    : QObject(parent)
+    , mCache(CACHED_NAMES)
+{
+    mDebounceTimer.setSingleShot(true);
+    mDebounceTimer.setInterval(DEBOUNCE_MSECS);
+    connect(&mDebounceTimer, &QTimer::timeout, this, &ContactGroupLookup::resolvePending);
+
+    // The shared lookup is destroyed after the application object, the
+    // searches have to end before
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &ContactGroupLookup::clear);
+    }
+}
+
+ContactGroupLookup::~ContactGroupLookup()
+{
+}
+
+void ContactGroupLookup::clear()
+{
+    mDebounceTimer.stop();
+    mPending.clear();
+    mSearching.clear();
+    const QList<KJob *> jobs = findChildren<KJob *>(QString(), Qt::FindDirectChildrenOnly);
+    for (KJob *job : jobs) {
+        job->kill(KJob::Quietly);
+    }
+}
+
+void ContactGroupLookup::lookup(const QString &name)
+{
+    if (name.isEmpty()) {
+        return;
+    }
+    mPending.insert(name);
+    // Restart the timer, so a burst of edits is resolved at once
+    mDebounceTimer.start();
+}
+
+void ContactGroupLookup::resolvePending()
+{
+    const QSet<QString> pending = mPending;
+    mPending.clear();
+
+    QStringList searching;
+    for (const QString &name : pending) {
+        const KContacts::ContactGroup::List *groups = mCache.object(name.toLower());
+        if (groups) {
+            Q_EMIT groupsFound(name, *groups);
+        } else if (!mSearching.contains(name)) {
+            searching.append(name);
+        }
+    }
+    if (searching.isEmpty()) {
+        return;
+    }
+
+    mSearching.unite(QSet<QString>(searching.cbegin(), searching.cend()));
+    search(searching);
+}
+
+void ContactGroupLookup::search(const QStringList &names)
+{
+    // Akonadi::ContactGroupSearchJob only searches for a single name, so
+    // search for the contact groups with any of the names directly.
+    Akonadi::SearchQuery query(Akonadi::SearchTerm::RelOr);
+    for (const QString &name : names) {
+        query.addTerm(Akonadi::ContactSearchTerm(Akonadi::ContactSearchTerm::Name, name, Akonadi::SearchTerm::CondEqual));
+    }
+
+    auto job = new Akonadi::ItemSearchJob(query, this);
+    job->setMimeTypes({KContacts::ContactGroup::mimeType()});
+    job->fetchScope().fetchFullPayload();
+    job->setProperty("names", names);
+    connect(job, &Akonadi::ItemSearchJob::result, this, &ContactGroupLookup::searchResult);
+}
+
+void ContactGroupLookup::searchResult(KJob *job)
+{
+    auto searchJob = qobject_cast<Akonadi::ItemSearchJob *>(job);
+    Q_ASSERT(searchJob);
+
+    KContacts::ContactGroup::List groups;
+    const Akonadi::Item::List items = searchJob->items();
+    for (const Akonadi::Item &item : items) {
+        if (item.hasPayload<KContacts::ContactGroup>()) {
+            groups.append(item.payload<KContacts::ContactGroup>());
+        }
+    }
+    groupsSearched(job->property("names").toStringList(), groups, job->error() != KJob::NoError);
+}
+
+void ContactGroupLookup::groupsSearched(const QStringList &names, const KContacts::ContactGroup::List &groups, bool failed)
+{
+    QHash<QString, KContacts::ContactGroup::List> groupsByName;
+    for (const KContacts::ContactGroup &group : groups) {
+        groupsByName[group.name().toLower()].append(group);
+    }
+
+    for (const QString &name : names) {
+        mSearching.remove(name);
+        const KContacts::ContactGroup::List found = groupsByName.value(name.toLower());
+        // Do not remember the failures, Akonadi might just not be up yet
+        if (!failed) {
+            mCache.insert(name.toLower(), new KContacts::ContactGroup::List(found));
+        }
+        Q_EMIT groupsFound(name, found);
+    }
+}
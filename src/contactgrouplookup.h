@@ -0,0 +1,84 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor_private_export.h"
+
+#include <KContacts/ContactGroup>
+
+#include <QCache>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+class KJob;
+
+namespace IncidenceEditorNG
+{
+/**
+ * Finds out which attendee names are contact groups.
+ *
+ * Names asked for with lookup() are collected for a short while and then
+ * searched for with a single Akonadi::ItemSearchJob for contact groups, so
+ * that pasting many addresses does not start a search per address. The results are kept
+ * in a cache of the most recently used names shared by all editors, so that
+ * reopening an editor does not search for the same names again.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT ContactGroupLookup : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Returns the lookup shared by all editors.
+     */
+    static ContactGroupLookup *instance();
+
+    explicit ContactGroupLookup(QObject *parent = nullptr);
+    ~ContactGroupLookup() override;
+
+    /**
+     * Schedules finding the contact groups named @p name. groupsFound() is
+     * emitted for it once the pending names are resolved, also when there is
+     * no such group.
+     */
+    void lookup(const QString &name);
+
+Q_SIGNALS:
+    /**
+     * Emitted with the contact groups named @p name, which is empty if @p name
+     * is not the name of a contact group.
+     */
+    void groupsFound(const QString &name, const KContacts::ContactGroup::List &groups);
+
+protected:
+    /**
+     * Starts searching for the contact groups named @p names, which ends in
+     * a call to groupsSearched().
+     */
+    virtual void search(const QStringList &names);
+
+    /**
+     * Announces the contact groups found in the search for @p names and
+     * caches them, unless the search has @p failed.
+     */
+    void groupsSearched(const QStringList &names, const KContacts::ContactGroup::List &groups, bool failed);
+
+private:
+    void resolvePending();
+    void searchResult(KJob *job);
+    /**
+     * Stops the running searches, so no job outlives the application.
+     */
+    void clear();
+
+    QTimer mDebounceTimer;
+    QSet<QString> mPending; //!< the names asked for since the last resolvePending()
+    QSet<QString> mSearching; //!< the names the running searches look for
+    QCache<QString, KContacts::ContactGroup::List> mCache; //!< by lower case name
+};
+}
+
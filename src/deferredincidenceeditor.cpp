@@ -0,0 +1,127 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "deferredincidenceeditor.h"
+
+#include "incidenceeditor_debug.h"
+
+using namespace IncidenceEditorNG;
+
+DeferredIncidenceEditor::DeferredIncidenceEditor(const Factory &factory, QObject *parent)
+    : IncidenceEditor(parent)
+    , mFactory(factory)
+{
+}
+
+DeferredIncidenceEditor::~DeferredIncidenceEditor()
+{
+    delete mEditor;
+}
+
+IncidenceEditor *DeferredIncidenceEditor::materialize()
+{
+    if (mEditor) {
+        return mEditor;
+    }
+
+    mEditor = mFactory();
+    Q_ASSERT(mEditor);
+
+    // Like CombinedIncidenceEditor, don't let loading change the dirty status.
+    mEditor->blockSignals(true);
+    if (mLoadedIncidence) {
+        mEditor->load(mLoadedIncidence);
+    }
+    if (mItemLoaded) {
+        mEditor->load(mLoadedItem);
+    }
+    mEditor->blockSignals(false);
+
+    if (mLoadedIncidence && mEditor->isDirty()) {
+        qCWarning(INCIDENCEEDITOR_LOG) << "Editor" << mEditor->objectName() << "is dirty right after being created";
+        mEditor->printDebugInfo();
+    }
+
+    connect(mEditor, &IncidenceEditor::dirtyStatusChanged, this, &IncidenceEditor::dirtyStatusChanged);
+    setDirtyStatusSource(mEditor);
+    Q_EMIT materialized(mEditor);
+    return mEditor;
+}
+
+IncidenceEditor *DeferredIncidenceEditor::editor() const
+{
+    return mEditor;
+}
+
+bool DeferredIncidenceEditor::isMaterialized() const
+{
+    return mEditor != nullptr;
+}
+
+void DeferredIncidenceEditor::load(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    mLoadedIncidence = incidence;
+    if (mEditor) {
+        mEditor->load(incidence);
+    }
+    mWasDirty = false;
+}
+
+void DeferredIncidenceEditor::load(const Akonadi::Item &item)
+{
+    mLoadedItem = item;
+    mItemLoaded = true;
+    if (mEditor) {
+        mEditor->load(item);
+    }
+}
+
+void DeferredIncidenceEditor::save(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    if (mEditor) {
+        mEditor->save(incidence);
+    }
+}
+
+void DeferredIncidenceEditor::save(Akonadi::Item &item)
+{
+    if (mEditor) {
+        mEditor->save(item);
+    }
+}
+
+bool DeferredIncidenceEditor::isDirty() const
+{
+    return mEditor && mEditor->isDirty();
+}
+
+bool DeferredIncidenceEditor::isValid() const
+{
+    if (!mEditor) {
+        mLastErrorString.clear();
+        return true;
+    }
+
+    const bool valid = mEditor->isValid();
+    mLastErrorString = mEditor->lastErrorString();
+    return valid;
+}
+
+void DeferredIncidenceEditor::focusInvalidField()
+{
+    if (mEditor) {
+        mEditor->focusInvalidField();
+    }
+}
+
+void DeferredIncidenceEditor::printDebugInfo() const
+{
+    if (mEditor) {
+        mEditor->printDebugInfo();
+    } else {
+        qCDebug(INCIDENCEEDITOR_LOG) << "Not materialized yet";
+    }
+}
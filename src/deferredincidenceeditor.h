@@ -0,0 +1,75 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor-ng.h"
+#include "incidenceeditor_private_export.h"
+
+#include <functional>
+
+namespace IncidenceEditorNG
+{
+/**
+ * Stands in for an IncidenceEditor which is only created once it is needed,
+ * e.g. when the tab holding its widgets is shown for the first time.
+ *
+ * Until then the incidence and item passed to load() are kept, the editor is
+ * neither dirty nor invalid, and save() leaves the incidence untouched: it is
+ * expected to be a copy of the loaded incidence, which already holds the
+ * unchanged values. Once materialize() has been called, all calls are
+ * forwarded to the created editor, which gets the kept incidence and item
+ * loaded first.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT DeferredIncidenceEditor : public IncidenceEditor
+{
+    Q_OBJECT
+public:
+    using Factory = std::function<IncidenceEditor *()>;
+
+    using IncidenceEditorNG::IncidenceEditor::load; // So we don't trigger -Woverloaded-virtual
+    using IncidenceEditorNG::IncidenceEditor::save; // So we don't trigger -Woverloaded-virtual
+    explicit DeferredIncidenceEditor(const Factory &factory, QObject *parent = nullptr);
+    /**
+     * Deletes the created editor, if any.
+     */
+    ~DeferredIncidenceEditor() override;
+
+    /**
+     * Creates the editor and loads the kept incidence and item into it, unless
+     * this has been done before. Returns the created editor.
+     */
+    IncidenceEditor *materialize();
+
+    /**
+     * Returns the created editor, or nullptr if materialize() wasn't called.
+     */
+    Q_REQUIRED_RESULT IncidenceEditor *editor() const;
+    Q_REQUIRED_RESULT bool isMaterialized() const;
+
+    void load(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void load(const Akonadi::Item &item) override;
+    void save(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void save(Akonadi::Item &item) override;
+    Q_REQUIRED_RESULT bool isDirty() const override;
+    Q_REQUIRED_RESULT bool isValid() const override;
+    void focusInvalidField() override;
+    void printDebugInfo() const override;
+
+Q_SIGNALS:
+    /**
+     * Emitted once the editor has been created and loaded.
+     */
+    void materialized(IncidenceEditorNG::IncidenceEditor *editor);
+
+private:
+    Factory mFactory;
+    IncidenceEditor *mEditor = nullptr;
+    Akonadi::Item mLoadedItem;
+    bool mItemLoaded = false;
+};
+}
+
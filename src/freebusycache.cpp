@@ -0,0 +1,265 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "freebusycache.h"
+#include "incidenceeditor_debug.h"
+
+#include <Akonadi/Calendar/FreeBusyManager>
+
+#include <KCalendarCore/FreeBusyPeriod>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace IncidenceEditorNG;
+
+static const quint32 CACHE_MAGIC = 0x46424331; // "FBC1"
+static const quint32 CACHE_VERSION = 1;
+static const int DEFAULT_TIME_TO_LIVE = 60 * 60; // 1 hour
+static const qint64 MAXIMUM_AGE_MSECS = 30LL * 24 * 60 * 60 * 1000; // entries older than 30 days are dropped
+static const int SAVE_DELAY_MSECS = 2000;
+
+static QString freeBusyCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/korganizer/freebusycache");
+}
+
+Q_GLOBAL_STATIC_WITH_ARGS(FreeBusyCache, sCache, (freeBusyCacheFile()))
+
+FreeBusyCache *FreeBusyCache::instance()
+{
+    return sCache;
+}
+
+FreeBusyCache::FreeBusyCache(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , mFileName(fileName)
+    , mTimeToLive(DEFAULT_TIME_TO_LIVE)
+{
+    mSaveTimer.setSingleShot(true);
+    mSaveTimer.setInterval(SAVE_DELAY_MSECS);
+    connect(&mSaveTimer, &QTimer::timeout, this, &FreeBusyCache::save);
+
+    // The shared cache outlives the application object, so write what the
+    // timer didn't get to yet and let go of the free/busy manager while the
+    // application is still around, static destruction is too late for that.
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &FreeBusyCache::tearDown);
+    }
+}
+
+FreeBusyCache::~FreeBusyCache() = default;
+
+KCalendarCore::FreeBusy::Ptr FreeBusyCache::freeBusy(const QString &email, bool *fresh) const
+{
+    load();
+    const auto it = mEntries.constFind(email.toLower());
+    if (it == mEntries.constEnd()) {
+        if (fresh) {
+            *fresh = false;
+        }
+        return {};
+    }
+
+    const Entry &entry = it.value();
+    if (fresh) {
+        *fresh = QDateTime::currentMSecsSinceEpoch() - entry.fetched < mTimeToLive * 1000LL;
+    }
+
+    KCalendarCore::FreeBusyPeriod::List periods;
+    periods.reserve(entry.starts.size());
+    for (int i = 0; i < entry.starts.size(); ++i) {
+        KCalendarCore::FreeBusyPeriod period(QDateTime::fromMSecsSinceEpoch(entry.starts.at(i), Qt::UTC),
+                                             QDateTime::fromMSecsSinceEpoch(entry.ends.at(i), Qt::UTC));
+        period.setType(static_cast<KCalendarCore::FreeBusyPeriod::FreeBusyType>(entry.types.at(i)));
+        periods.append(period);
+    }
+    return KCalendarCore::FreeBusy::Ptr(new KCalendarCore::FreeBusy(periods));
+}
+
+void FreeBusyCache::insert(const QString &email, const KCalendarCore::FreeBusy::Ptr &freeBusy)
+{
+    if (email.isEmpty() || !freeBusy) {
+        return;
+    }
+    load();
+
+    Entry entry;
+    entry.fetched = QDateTime::currentMSecsSinceEpoch();
+    const KCalendarCore::FreeBusyPeriod::List periods = freeBusy->fullBusyPeriods();
+    entry.starts.reserve(periods.size());
+    entry.ends.reserve(periods.size());
+    entry.types.reserve(periods.size());
+    for (const KCalendarCore::FreeBusyPeriod &period : periods) {
+        entry.starts.append(period.start().toMSecsSinceEpoch());
+        entry.ends.append(period.end().toMSecsSinceEpoch());
+        entry.types.append(static_cast<qint8>(period.type()));
+    }
+    entry.checksum = qHash(entry.starts, qHash(entry.ends, qHash(entry.types)));
+
+    Entry &stored = mEntries[email.toLower()];
+    // Unchanged data only needs a new timestamp, which can wait for the next
+    // change unless the stored one is about to expire.
+    const bool unchanged = stored.checksum == entry.checksum && stored.starts == entry.starts && stored.ends == entry.ends && stored.types == entry.types;
+    const bool expiring = entry.fetched - stored.fetched >= mTimeToLive * 500LL;
+    stored = entry;
+    if (!unchanged || expiring) {
+        mModified = true;
+        mSaveTimer.start();
+    }
+}
+
+void FreeBusyCache::clear()
+{
+    // Without loading the file first, it has to be overwritten anyway
+    const bool hadEntries = !mLoaded || !mEntries.isEmpty();
+    mLoaded = true;
+    mEntries.clear();
+    if (hadEntries) {
+        mModified = true;
+        mSaveTimer.start();
+    }
+}
+
+void FreeBusyCache::tearDown()
+{
+    save();
+    if (mPrefetchConnected) {
+        disconnect(Akonadi::FreeBusyManager::self(), nullptr, this, nullptr);
+        mPrefetchConnected = false;
+    }
+    mPrefetching.clear();
+}
+
+void FreeBusyCache::prefetch(const KCalendarCore::Attendee::List &attendees, QWidget *parentWidget)
+{
+    Akonadi::FreeBusyManager *manager = Akonadi::FreeBusyManager::self();
+    if (!mPrefetchConnected) {
+        mPrefetchConnected = true;
+        connect(manager, &Akonadi::FreeBusyManager::freeBusyRetrieved, this, &FreeBusyCache::freeBusyRetrieved);
+        connect(manager, &Akonadi::FreeBusyManager::freeBusyRetrievalError, this, &FreeBusyCache::freeBusyRetrievalError);
+    }
+
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        const QString email = attendee.email().toLower();
+        if (email.isEmpty() || mPrefetching.contains(email)) {
+            continue;
+        }
+        bool fresh = false;
+        if (freeBusy(email, &fresh) && fresh) {
+            continue;
+        }
+        if (manager->retrieveFreeBusy(attendee.email(), false, parentWidget)) {
+            mPrefetching.insert(email);
+        }
+    }
+}
+
+bool FreeBusyCache::isPrefetching(const QString &email) const
+{
+    return mPrefetching.contains(email.toLower());
+}
+
+void FreeBusyCache::freeBusyRetrieved(const KCalendarCore::FreeBusy::Ptr &freeBusy, const QString &email)
+{
+    // The ones retrieved for the editors are stored by ConflictResolver
+    if (mPrefetching.remove(email.toLower())) {
+        insert(email, freeBusy);
+    }
+}
+
+void FreeBusyCache::freeBusyRetrievalError(const QString &email, const QString &errorMessage)
+{
+    // Forget the failed ones, so the next prefetch() tries them again
+    if (mPrefetching.remove(email.toLower())) {
+        qCDebug(INCIDENCEEDITOR_LOG) << "Unable to prefetch the free/busy data of" << email << errorMessage;
+        Q_EMIT prefetchFailed(email);
+    }
+}
+
+void FreeBusyCache::setTimeToLive(int seconds)
+{
+    mTimeToLive = seconds;
+}
+
+int FreeBusyCache::timeToLive() const
+{
+    return mTimeToLive;
+}
+
+bool FreeBusyCache::save()
+{
+    mSaveTimer.stop();
+    if (!mModified) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(mFileName).absolutePath());
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(INCIDENCEEDITOR_LOG) << "Unable to write the free/busy cache" << mFileName << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << CACHE_MAGIC << CACHE_VERSION << qint32(mEntries.size());
+    for (auto it = mEntries.cbegin(), end = mEntries.cend(); it != end; ++it) {
+        const Entry &entry = it.value();
+        stream << it.key() << entry.fetched << entry.checksum << entry.starts << entry.ends << entry.types;
+    }
+    if (!file.commit()) {
+        qCWarning(INCIDENCEEDITOR_LOG) << "Unable to write the free/busy cache" << mFileName << file.errorString();
+        return false;
+    }
+    mModified = false;
+    return true;
+}
+
+void FreeBusyCache::load() const
+{
+    if (mLoaded) {
+        return;
+    }
+    mLoaded = true;
+
+    QFile file(mFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || count < 0) {
+        // Another format, start over
+        return;
+    }
+
+    const qint64 oldest = QDateTime::currentMSecsSinceEpoch() - MAXIMUM_AGE_MSECS;
+    mEntries.reserve(count);
+    for (qint32 i = 0; i < count; ++i) {
+        QString email;
+        Entry entry;
+        stream >> email >> entry.fetched >> entry.checksum >> entry.starts >> entry.ends >> entry.types;
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(INCIDENCEEDITOR_LOG) << "The free/busy cache" << mFileName << "is damaged";
+            mEntries.clear();
+            return;
+        }
+        if (entry.fetched >= oldest && entry.starts.size() == entry.ends.size() && entry.starts.size() == entry.types.size()) {
+            mEntries.insert(email, entry);
+        }
+    }
+}
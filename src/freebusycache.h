@@ -0,0 +1,123 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor_private_export.h"
+
+#include <KCalendarCore/FreeBusy>
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+class QWidget;
+
+namespace IncidenceEditorNG
+{
+/**
+ * Keeps the busy periods of attendees on disk, by email address.
+ *
+ * ConflictResolver hands the cached periods of an attendee to the free/busy
+ * model right away, and skips fetching them again while they are younger
+ * than timeToLive(). Fetched data is stored back into the cache.
+ *
+ * The cache is a compact binary file holding the start, end and busy type of
+ * each period, read on first use and written back shortly after a change.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT FreeBusyCache : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Returns the cache shared by all editors, stored next to the free/busy
+     * URLs of FreeBusyUrlDialog.
+     */
+    static FreeBusyCache *instance();
+
+    explicit FreeBusyCache(const QString &fileName, QObject *parent = nullptr);
+    ~FreeBusyCache() override;
+
+    /**
+     * Returns the cached busy periods of @p email, or a null pointer if there
+     * are none. @p fresh is set to whether they are younger than timeToLive().
+     */
+    Q_REQUIRED_RESULT KCalendarCore::FreeBusy::Ptr freeBusy(const QString &email, bool *fresh = nullptr) const;
+
+    /**
+     * Stores the busy periods of @p freeBusy as the ones of @p email, fetched now.
+     */
+    void insert(const QString &email, const KCalendarCore::FreeBusy::Ptr &freeBusy);
+
+    /**
+     * Drops the busy periods of all attendees, from disk as well once saved.
+     */
+    void clear();
+
+    /**
+     * Starts fetching the free/busy data of @p attendees with no fresh data
+     * in the cache, storing it in the cache once it arrives. Used to get the
+     * data while the editor is still being set up.
+     */
+    void prefetch(const KCalendarCore::Attendee::List &attendees, QWidget *parentWidget = nullptr);
+
+    /**
+     * Returns whether the data of @p email is being fetched by prefetch().
+     * FreeBusyManager hands it to every listener once it arrives, so it
+     * needs no other request.
+     */
+    Q_REQUIRED_RESULT bool isPrefetching(const QString &email) const;
+
+    /**
+     * Sets the age in seconds up to which cached periods are used without
+     * fetching them again.
+     */
+    void setTimeToLive(int seconds);
+    Q_REQUIRED_RESULT int timeToLive() const;
+
+    /**
+     * Writes pending changes to disk. Returns false if that failed.
+     */
+    bool save();
+
+Q_SIGNALS:
+    /**
+     * Emitted when the data of @p email could not be prefetched, so whoever
+     * waited for it can fetch it by itself.
+     */
+    void prefetchFailed(const QString &email);
+
+private:
+    struct Entry {
+        qint64 fetched = 0; //!< msecs since epoch
+        quint32 checksum = 0;
+        QVector<qint64> starts; //!< msecs since epoch
+        QVector<qint64> ends;
+        QVector<qint8> types; //!< KCalendarCore::FreeBusyPeriod::FreeBusyType
+    };
+
+    void load() const;
+    /**
+     * Saves pending changes and stops waiting for prefetched data, so
+     * nothing is left to do once the application object is gone.
+     */
+    void tearDown();
+    void freeBusyRetrieved(const KCalendarCore::FreeBusy::Ptr &freeBusy, const QString &email);
+    void freeBusyRetrievalError(const QString &email, const QString &errorMessage);
+
+    const QString mFileName;
+    mutable QHash<QString, Entry> mEntries; //!< by lower case email
+    mutable bool mLoaded = false;
+    bool mModified = false;
+    bool mPrefetchConnected = false;
+    QSet<QString> mPrefetching; //!< the lower case emails prefetch() waits for
+    int mTimeToLive;
+    QTimer mSaveTimer;
+};
+}
+
@@ -13,15 +13,126 @@
 
 #include <KLocalizedString>
 
+#include <QIdentityProxyModel>
 #include <QLocale>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace IncidenceEditorNG;
 
+/**
+ * Passes the free/busy model on unchanged, but lets FreeBusyGanttProxyModel
+ * announce all periods of an attendee as changed, so QSortFilterProxyModel
+ * filters them again.
+ */
+class FreeBusyGanttProxyModel::SourceProxy : public QIdentityProxyModel
+{
+public:
+    using QIdentityProxyModel::QIdentityProxyModel;
+
+    void periodsChanged(const QModelIndex &parent)
+    {
+        const int periods = rowCount(parent);
+        if (periods > 0) {
+            Q_EMIT dataChanged(index(0, 0, parent), index(periods - 1, 0, parent));
+        }
+    }
+};
+
 FreeBusyGanttProxyModel::FreeBusyGanttProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
+    , mSourceProxy(new SourceProxy(this))
 {
 }
 
+void FreeBusyGanttProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    for (const QMetaObject::Connection &connection : qAsConst(mSourceConnections)) {
+        disconnect(connection);
+    }
+    mSourceConnections.clear();
+    invalidateAll();
+
+    // Connect before QSortFilterProxyModel does, so the cache is already
+    // up to date when the views learn about a change and query the data.
+    if (model) {
+        mSourceConnections = {
+            connect(model,
+                    &QAbstractItemModel::dataChanged,
+                    this,
+                    [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                        // a changed period may join or split spans, so the whole attendee goes
+                        const QModelIndex parent = topLeft.parent();
+                        if (!parent.isValid()) {
+                            invalidateAttendees(topLeft.row(), bottomRight.row());
+                        } else {
+                            invalidatePeriods(parent);
+                        }
+                    }),
+            connect(model,
+                    &QAbstractItemModel::rowsInserted,
+                    this,
+                    [this](const QModelIndex &parent, int first, int last) {
+                        if (parent.isValid()) {
+                            invalidatePeriods(parent);
+                        } else if (first < mCache.size()) {
+                            mCache.insert(first, last - first + 1, CachedAttendee());
+                        }
+                    }),
+            connect(model,
+                    &QAbstractItemModel::rowsRemoved,
+                    this,
+                    [this](const QModelIndex &parent, int first, int last) {
+                        if (parent.isValid()) {
+                            invalidatePeriods(parent);
+                        } else if (first < mCache.size()) {
+                            mCache.remove(first, qMin(last + 1, mCache.size()) - first);
+                        }
+                    }),
+            connect(model, &QAbstractItemModel::rowsMoved, this, &FreeBusyGanttProxyModel::invalidateAll),
+            connect(model, &QAbstractItemModel::layoutChanged, this, &FreeBusyGanttProxyModel::invalidateAll),
+            connect(model, &QAbstractItemModel::modelReset, this, &FreeBusyGanttProxyModel::invalidateAll),
+        };
+    }
+    mSourceProxy->setSourceModel(model);
+    QSortFilterProxyModel::setSourceModel(model ? mSourceProxy : nullptr);
+
+    // Connect after QSortFilterProxyModel as well: it only refilters the
+    // changed periods, while the whole attendee was merged again.
+    if (model) {
+        mSourceConnections += {
+            connect(model,
+                    &QAbstractItemModel::dataChanged,
+                    this,
+                    [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                        const QModelIndex parent = topLeft.parent();
+                        if (!parent.isValid()) {
+                            spansChanged(topLeft.row(), bottomRight.row());
+                        } else {
+                            spansChanged(parent.row(), parent.row());
+                        }
+                    }),
+            connect(model,
+                    &QAbstractItemModel::rowsInserted,
+                    this,
+                    [this](const QModelIndex &parent) {
+                        if (parent.isValid()) {
+                            spansChanged(parent.row(), parent.row());
+                        }
+                    }),
+            connect(model,
+                    &QAbstractItemModel::rowsRemoved,
+                    this,
+                    [this](const QModelIndex &parent) {
+                        if (parent.isValid()) {
+                            spansChanged(parent.row(), parent.row());
+                        }
+                    }),
+        };
+    }
+}
+
 QVariant FreeBusyGanttProxyModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid()) {
@@ -42,19 +153,25 @@ QVariant FreeBusyGanttProxyModel::data(const QModelIndex &index, int role) const
     }
 
     // if the index is valid, then it corresponds to a free busy period
-    auto period = sourceModel()->data(source_index, CalendarSupport::FreeBusyItemModel::FreeBusyPeriodRole).value<KCalendarCore::FreeBusyPeriod>();
-
     switch (role) {
     case KGantt::ItemTypeRole:
         return KGantt::TypeTask;
     case KGantt::StartTimeRole:
-        return period.start().toLocalTime();
+        return cachedPeriod(source_index).start;
     case KGantt::EndTimeRole:
-        return period.end().toLocalTime();
+        return cachedPeriod(source_index).spanEnd;
     case Qt::BackgroundRole:
         return QColor(Qt::red);
-    case Qt::ToolTipRole:
-        return tooltipify(period);
+    case Qt::ToolTipRole: {
+        CachedPeriod &cached = cachedPeriod(source_index);
+        if (cached.toolTip.isEmpty()) {
+            cached.toolTip = cached.spanCount > 1 ? spanTooltip(cached)
+                                                  : tooltipify(sourceModel()
+                                                                   ->data(source_index, CalendarSupport::FreeBusyItemModel::FreeBusyPeriodRole)
+                                                                   .value<KCalendarCore::FreeBusyPeriod>());
+        }
+        return cached.toolTip;
+    }
     case Qt::DisplayRole:
         return sourceModel()->data(source_index.parent(), Qt::DisplayRole);
     default:
@@ -62,8 +179,186 @@ QVariant FreeBusyGanttProxyModel::data(const QModelIndex &index, int role) const
     }
 }
 
+void FreeBusyGanttProxyModel::setVisibleWindow(const QDateTime &start, const QDateTime &end, int firstRow, int lastRow)
+{
+    if (start == mWindowStart && end == mWindowEnd && firstRow == mWindowFirstRow && lastRow == mWindowLastRow) {
+        return;
+    }
+    mWindowStart = start;
+    mWindowEnd = end;
+    mWindowFirstRow = firstRow;
+    mWindowLastRow = lastRow;
+    invalidateFilter();
+}
+
+void FreeBusyGanttProxyModel::setMergeDistance(int seconds)
+{
+    seconds = qMax(seconds, 0);
+    if (seconds == mMergeDistance) {
+        return;
+    }
+    mMergeDistance = seconds;
+    invalidateFilter();
+    emitSpansChanged(0, rowCount() - 1);
+}
+
+bool FreeBusyGanttProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!sourceParent.isValid()) {
+        return true;
+    }
+    if (mWindowStart.isValid() && (sourceParent.row() < mWindowFirstRow || sourceParent.row() > mWindowLastRow)) {
+        return false;
+    }
+    if (!mWindowStart.isValid() && mMergeDistance == 0) {
+        return true;
+    }
+    const CachedPeriod &cached = cachedPeriod(sourceModel()->index(sourceRow, 0, sourceParent));
+    if (cached.spanCount == 0) {
+        return false;
+    }
+    return !mWindowStart.isValid() || (cached.start < mWindowEnd && cached.spanEnd > mWindowStart);
+}
+
+FreeBusyGanttProxyModel::CachedPeriod &FreeBusyGanttProxyModel::cachedPeriod(const QModelIndex &sourceIndex) const
+{
+    return cachedAttendee(sourceIndex.parent()).periods[sourceIndex.row()];
+}
+
+FreeBusyGanttProxyModel::CachedAttendee &FreeBusyGanttProxyModel::cachedAttendee(const QModelIndex &sourceParent) const
+{
+    if (mCache.size() <= sourceParent.row()) {
+        mCache.resize(sourceModel()->rowCount());
+    }
+    CachedAttendee &attendee = mCache[sourceParent.row()];
+    if (!attendee.valid) {
+        const int rows = sourceModel()->rowCount(sourceParent);
+        attendee.periods.resize(rows);
+        for (int row = 0; row < rows; ++row) {
+            const auto period = sourceModel()
+                                    ->data(sourceModel()->index(row, 0, sourceParent), CalendarSupport::FreeBusyItemModel::FreeBusyPeriodRole)
+                                    .value<KCalendarCore::FreeBusyPeriod>();
+            CachedPeriod &cached = attendee.periods[row];
+            cached.start = period.start().toLocalTime();
+            cached.end = period.end().toLocalTime();
+            cached.spanEnd = cached.end;
+        }
+        attendee.mergeDistance = 0;
+        attendee.valid = true;
+    }
+    if (attendee.mergeDistance != mMergeDistance) {
+        mergePeriods(attendee);
+    }
+    return attendee;
+}
+
+void FreeBusyGanttProxyModel::mergePeriods(CachedAttendee &attendee) const
+{
+    QVector<CachedPeriod> &periods = attendee.periods;
+    attendee.mergeDistance = mMergeDistance;
+    if (mMergeDistance == 0) {
+        // every period on its own, even overlapping ones
+        for (CachedPeriod &period : periods) {
+            period.toolTip.clear();
+            period.spanEnd = period.end;
+            period.spanCount = 1;
+        }
+        return;
+    }
+
+    QVector<int> order(periods.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&periods](int left, int right) {
+        return periods.at(left).start < periods.at(right).start;
+    });
+
+    const qint64 distance = qint64(mMergeDistance) * 1000;
+    CachedPeriod *span = nullptr;
+    qint64 spanEnd = 0;
+    for (const int row : qAsConst(order)) {
+        CachedPeriod &period = periods[row];
+        period.toolTip.clear();
+        const qint64 start = period.start.toMSecsSinceEpoch();
+        const qint64 end = period.end.toMSecsSinceEpoch();
+        if (span && start - spanEnd < distance) {
+            if (end > spanEnd) {
+                span->spanEnd = period.end;
+                spanEnd = end;
+            }
+            ++span->spanCount;
+            period.spanCount = 0;
+            period.spanEnd = period.end;
+        } else {
+            span = &period;
+            span->spanEnd = period.end;
+            span->spanCount = 1;
+            spanEnd = end;
+        }
+    }
+}
+
+void FreeBusyGanttProxyModel::invalidateAttendees(int first, int last)
+{
+    for (int row = first; row <= last && row < mCache.size(); ++row) {
+        mCache[row] = CachedAttendee();
+    }
+}
+
+void FreeBusyGanttProxyModel::invalidatePeriods(const QModelIndex &sourceParent)
+{
+    invalidateAttendees(sourceParent.row(), sourceParent.row());
+}
+
+void FreeBusyGanttProxyModel::invalidateAll()
+{
+    mCache.clear();
+}
+
+void FreeBusyGanttProxyModel::spansChanged(int first, int last)
+{
+    // Without merging, every period is a span of its own and only the changed
+    // ones are affected.
+    if (mMergeDistance == 0) {
+        return;
+    }
+    // The other periods of the attendees may have joined or left a span, or
+    // end elsewhere now. Refilter them, and only them.
+    for (int row = first; row <= last && row < mSourceProxy->rowCount(); ++row) {
+        mSourceProxy->periodsChanged(mSourceProxy->index(row, 0));
+    }
+}
+
+void FreeBusyGanttProxyModel::emitSpansChanged(int first, int last)
+{
+    // the spans which are still there may end elsewhere now
+    for (int row = first; row <= last && row < rowCount(); ++row) {
+        const QModelIndex parent = index(row, 0);
+        const int periods = rowCount(parent);
+        if (periods > 0) {
+            Q_EMIT dataChanged(index(0, 0, parent), index(periods - 1, 0, parent), {KGantt::EndTimeRole, Qt::ToolTipRole});
+        }
+    }
+}
+
+QString FreeBusyGanttProxyModel::spanTooltip(const CachedPeriod &span) const
+{
+    const QLocale locale;
+    QString toolTip = QStringLiteral("<qt>");
+    toolTip += QLatin1String("<b>") + i18ncp("@info:tooltip", "%1 Free/Busy Period", "%1 Free/Busy Periods", span.spanCount) + QLatin1String("</b>");
+    toolTip += QStringLiteral("<hr>");
+    toolTip += QStringLiteral("<i>") + i18nc("@info:tooltip period start time", "Start:") + QStringLiteral("</i>") + QStringLiteral("&nbsp;");
+    toolTip += locale.toString(span.start, QLocale::ShortFormat);
+    toolTip += QStringLiteral("<br>");
+    toolTip += QStringLiteral("<i>") + i18nc("@info:tooltip period end time", "End:") + QStringLiteral("</i>") + QStringLiteral("&nbsp;");
+    toolTip += locale.toString(span.spanEnd, QLocale::ShortFormat);
+    toolTip += QStringLiteral("<br>");
+    toolTip += QStringLiteral("</qt>");
+    return toolTip;
+}
+
 QString FreeBusyGanttProxyModel::tooltipify(const KCalendarCore::FreeBusyPeriod &period) const
 {
+    const QLocale locale;
     QString toolTip = QStringLiteral("<qt>");
     toolTip += QLatin1String("<b>") + i18nc("@info:tooltip", "Free/Busy Period") + QLatin1String("</b>");
     toolTip += QStringLiteral("<hr>");
@@ -78,10 +373,10 @@ QString FreeBusyGanttProxyModel::tooltipify(const KCalendarCore::FreeBusyPeriod
         toolTip += QStringLiteral("<br>");
     }
     toolTip += QStringLiteral("<i>") + i18nc("@info:tooltip period start time", "Start:") + QStringLiteral("</i>") + QStringLiteral("&nbsp;");
-    toolTip += QLocale().toString(period.start().toLocalTime(), QLocale::ShortFormat);
+    toolTip += locale.toString(period.start().toLocalTime(), QLocale::ShortFormat);
     toolTip += QStringLiteral("<br>");
     toolTip += QStringLiteral("<i>") + i18nc("@info:tooltip period end time", "End:") + QStringLiteral("</i>") + QStringLiteral("&nbsp;");
-    toolTip += QLocale().toString(period.end().toLocalTime(), QLocale::ShortFormat);
+    toolTip += locale.toString(period.end().toLocalTime(), QLocale::ShortFormat);
     toolTip += QStringLiteral("<br>");
     toolTip += QStringLiteral("</qt>");
     return toolTip;
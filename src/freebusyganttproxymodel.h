@@ -9,7 +9,9 @@
 
 #include "incidenceeditor_export.h"
 
+#include <QDateTime>
 #include <QSortFilterProxyModel>
+#include <QVector>
 
 namespace KCalendarCore
 {
@@ -33,8 +35,80 @@ class INCIDENCEEDITOR_EXPORT FreeBusyGanttProxyModel : public QSortFilterProxyMo
     Q_OBJECT
 public:
     explicit FreeBusyGanttProxyModel(QObject *parent = nullptr);
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
     Q_REQUIRED_RESULT QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     Q_REQUIRED_RESULT QString tooltipify(const KCalendarCore::FreeBusyPeriod &period) const;
+
+    /**
+     * Restricts the exposed free/busy periods to the ones of the attendees in
+     * the rows @p firstRow to @p lastRow which intersect the time range
+     * (@p start, @p end). Attendee rows are always exposed, so the rows keep
+     * lining up with the attendee list. An invalid @p start exposes all periods,
+     * which is the default.
+     *
+     * This lets the Gantt view create items for the visible part of the chart only.
+     */
+    void setVisibleWindow(const QDateTime &start, const QDateTime &end, int firstRow, int lastRow);
+
+    /**
+     * Merges the free/busy periods of an attendee which are less than
+     * @p seconds apart into one span, exposed as its earliest period ending
+     * at the end of the span. 0 exposes every period on its own, which is the
+     * default.
+     *
+     * Set to the time a pixel of the chart stands for, this keeps the number
+     * of Gantt items proportional to the width of the chart when zoomed out.
+     */
+    void setMergeDistance(int seconds);
+
+protected:
+    Q_REQUIRED_RESULT bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    /**
+     * The data KGantt asks for while painting a free/busy period, converted
+     * once and kept until the period changes in the source model.
+     */
+    struct CachedPeriod {
+        QDateTime start;
+        QDateTime end;
+        QDateTime spanEnd; //!< the end of the span of merged periods starting with this one
+        int spanCount = 1; //!< the number of periods in the span, 0 if merged into another one
+        QString toolTip; //!< generated on the first tooltip request
+    };
+
+    struct CachedAttendee {
+        QVector<CachedPeriod> periods;
+        int mergeDistance = 0; //!< the merge distance the spans are computed for
+        bool valid = false;
+    };
+
+    CachedPeriod &cachedPeriod(const QModelIndex &sourceIndex) const;
+    CachedAttendee &cachedAttendee(const QModelIndex &sourceParent) const;
+    void mergePeriods(CachedAttendee &attendee) const;
+    QString spanTooltip(const CachedPeriod &span) const;
+    void invalidateAttendees(int first, int last);
+    void invalidatePeriods(const QModelIndex &sourceParent);
+    void invalidateAll();
+    /**
+     * Refilters the periods of the attendees in the source rows @p first to
+     * @p last after a change, which re-merged all of their periods.
+     */
+    void spansChanged(int first, int last);
+    void emitSpansChanged(int first, int last);
+
+    class SourceProxy;
+    SourceProxy *const mSourceProxy; //!< the source model as seen by QSortFilterProxyModel
+
+    // indexed by the rows of the attendee and of the period in the source model
+    mutable QVector<CachedAttendee> mCache;
+    QVector<QMetaObject::Connection> mSourceConnections;
+
+    QDateTime mWindowStart;
+    QDateTime mWindowEnd;
+    int mWindowFirstRow = 0;
+    int mWindowLastRow = 0;
+    int mMergeDistance = 0;
 };
 }
 
@@ -0,0 +1,155 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "freebusyheatmap.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace IncidenceEditorNG;
+
+static const int TILE_WIDTH = 512;
+static const int MAX_TILES = 64;
+
+FreeBusyHeatMap::FreeBusyHeatMap(QWidget *parent)
+    : QWidget(parent)
+    , mTiles(MAX_TILES)
+{
+}
+
+FreeBusyHeatMap::~FreeBusyHeatMap()
+{
+}
+
+void FreeBusyHeatMap::setBusyCounts(const SlotGrid &grid, const QVector<int> &counts)
+{
+    const int maximum = counts.isEmpty() ? 0 : *std::max_element(counts.constBegin(), counts.constEnd());
+    if (grid == mGrid && counts.size() == mCounts.size() && maximum == mMaximum) {
+        // Redraw the tiles of the changed slots only, usually the ones
+        // of the busy periods of a single attendee
+        const auto mismatch = std::mismatch(counts.constBegin(), counts.constEnd(), mCounts.constBegin());
+        if (mismatch.first == counts.constEnd()) {
+            return;
+        }
+        auto last = counts.constEnd() - 1;
+        auto lastOld = mCounts.constEnd() - 1;
+        while (*last == *lastOld) {
+            --last;
+            --lastOld;
+        }
+        mCounts = counts;
+        invalidateSlots(mismatch.first - counts.constBegin(), last - counts.constBegin());
+        return;
+    }
+
+    mGrid = grid;
+    mCounts = counts;
+    mMaximum = maximum;
+    mTiles.clear();
+    update();
+}
+
+void FreeBusyHeatMap::setTimeScale(const QDateTime &origin, qreal pixelsPerSecond)
+{
+    const qint64 originMSecs = origin.toMSecsSinceEpoch();
+    if (originMSecs == mOriginMSecs && qFuzzyCompare(pixelsPerSecond, mPixelsPerSecond)) {
+        return;
+    }
+    mOriginMSecs = originMSecs;
+    mPixelsPerSecond = pixelsPerSecond;
+    mTiles.clear();
+    update();
+}
+
+void FreeBusyHeatMap::setScrollOffset(qreal offset)
+{
+    if (offset != mScrollOffset) {
+        mScrollOffset = offset;
+        update();
+    }
+}
+
+void FreeBusyHeatMap::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    if (mCounts.isEmpty() || mPixelsPerSecond <= 0) {
+        return;
+    }
+
+    const int firstTile = std::floor((event->rect().left() + mScrollOffset) / TILE_WIDTH);
+    const int lastTile = std::floor((event->rect().right() + mScrollOffset) / TILE_WIDTH);
+    for (int tile = firstTile; tile <= lastTile; ++tile) {
+        QPixmap *pixmap = mTiles.object(tile);
+        if (!pixmap) {
+            pixmap = new QPixmap(renderTile(tile));
+            mTiles.insert(tile, pixmap);
+        }
+        painter.drawPixmap(QPointF(qreal(tile) * TILE_WIDTH - mScrollOffset, 0), *pixmap);
+    }
+}
+
+void FreeBusyHeatMap::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (event->oldSize().height() != height()) {
+        mTiles.clear();
+    }
+}
+
+qreal FreeBusyHeatMap::slotPosition(int slot) const
+{
+    const qint64 secs = (mGrid.begin().toMSecsSinceEpoch() - mOriginMSecs) / 1000 + qint64(slot) * mGrid.resolution();
+    return secs * mPixelsPerSecond;
+}
+
+QPixmap FreeBusyHeatMap::renderTile(int tile) const
+{
+    const qreal dpr = devicePixelRatioF();
+    QPixmap pixmap(QSize(TILE_WIDTH, height()) * dpr);
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+
+    // the slots overlapping the tile
+    const qreal left = qreal(tile) * TILE_WIDTH;
+    const qreal slotWidth = mGrid.resolution() * mPixelsPerSecond;
+    const int range = mCounts.size();
+    int slot = qBound(0, int(std::floor((left - slotPosition(0)) / slotWidth)), range);
+    const int lastSlot = qBound(0, int(std::ceil((left + TILE_WIDTH - slotPosition(0)) / slotWidth)), range);
+
+    QPainter painter(&pixmap);
+    QColor color(Qt::red);
+    while (slot < lastSlot) {
+        // draw runs of equal counts at once
+        const int count = mCounts.at(slot);
+        int end = slot + 1;
+        while (end < lastSlot && mCounts.at(end) == count) {
+            ++end;
+        }
+        if (count > 0) {
+            color.setAlpha(48 + 207 * count / qMax(mMaximum, 1));
+            const qreal x = slotPosition(slot) - left;
+            painter.fillRect(QRectF(x, 0, slotPosition(end) - left - x, height()), color);
+        }
+        slot = end;
+    }
+    return pixmap;
+}
+
+void FreeBusyHeatMap::invalidateSlots(int first, int last)
+{
+    if (mPixelsPerSecond <= 0) {
+        return;
+    }
+    const int firstTile = std::floor(slotPosition(first) / TILE_WIDTH);
+    const int lastTile = std::floor(slotPosition(last + 1) / TILE_WIDTH);
+    for (int tile = firstTile; tile <= lastTile; ++tile) {
+        mTiles.remove(tile);
+    }
+    update(QRect(QPoint(std::floor(slotPosition(first) - mScrollOffset), 0), QPoint(std::ceil(slotPosition(last + 1) - mScrollOffset), height())));
+}
@@ -0,0 +1,71 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "slotgrid.h"
+
+#include <QCache>
+#include <QPixmap>
+#include <QVector>
+#include <QWidget>
+
+namespace IncidenceEditorNG
+{
+/**
+ * A strip below the free/busy chart showing for every time slot how many
+ * attendees are busy in it, the darker the more.
+ *
+ * The strip is drawn in tiles of a fixed width, which are kept until the
+ * time scale changes. When the counts change on the same slot grid, only
+ * the tiles covering the changed slots are drawn again.
+ *
+ * @see ConflictResolver::busyCounts
+ */
+class FreeBusyHeatMap : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit FreeBusyHeatMap(QWidget *parent = nullptr);
+    ~FreeBusyHeatMap() override;
+
+    /**
+     * Sets the busy counts to show, one for each slot of @p grid.
+     */
+    void setBusyCounts(const SlotGrid &grid, const QVector<int> &counts);
+
+    /**
+     * Sets the time scale of the chart: @p origin lies at chart position 0,
+     * and every second takes @p pixelsPerSecond pixels.
+     */
+    void setTimeScale(const QDateTime &origin, qreal pixelsPerSecond);
+
+    /**
+     * Sets the chart position shown at the left edge of the widget.
+     */
+    void setScrollOffset(qreal offset);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    QPixmap renderTile(int tile) const;
+    void invalidateSlots(int first, int last);
+    qreal slotPosition(int slot) const;
+
+    SlotGrid mGrid;
+    QVector<int> mCounts;
+    int mMaximum = 0;
+
+    qint64 mOriginMSecs = 0;
+    qreal mPixelsPerSecond = 0;
+    qreal mScrollOffset = 0;
+
+    QCache<int, QPixmap> mTiles; //!< the drawn tiles of the current time scale, by index
+};
+}
+
@@ -7,6 +7,7 @@
 #include "groupwareuidelegate.h"
 #include "incidencedialog.h"
 #include "incidencedialogfactory.h"
+#include "freebusycache.h"
 
 #include <CalendarSupport/Utils>
 
@@ -26,13 +27,17 @@ void GroupwareUiDelegate::requestIncidenceEditor(const Akonadi::Item &item)
         return;
     }
 
+    // Get the free/busy data of the attendees while the dialog is set up
+    FreeBusyCache::instance()->prefetch(incidence->attendees());
+
     IncidenceDialog *dialog = IncidenceDialogFactory::create(/*needs initial saving=*/false, incidence->type(), nullptr);
     dialog->setAttribute(Qt::WA_DeleteOnClose, false);
     dialog->setIsCounterProposal(true);
     dialog->load(item, QDate::currentDate());
     dialog->exec();
-    dialog->deleteLater();
-    Akonadi::Item newItem = dialog->item();
+    const Akonadi::Item newItem = dialog->item();
+    // Hand the dialog back for the next invitation, it is reset then
+    IncidenceDialogFactory::releaseDialog(dialog);
     if (newItem.hasPayload<KCalendarCore::Incidence::Ptr>()) {
         KCalendarCore::IncidenceBase::Ptr newIncidence = newItem.payload<KCalendarCore::Incidence::Ptr>();
         *incidence.staticCast<KCalendarCore::IncidenceBase>() = *newIncidence;
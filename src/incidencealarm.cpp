@@ -131,7 +131,7 @@ void IncidenceAlarm::editCurrentAlarm()
     if (dialog->exec() == QDialog::Accepted) {
         dialog->save(currentAlarm);
         updateAlarmList();
-        checkDirtyStatus();
+        scheduleDirtyCheck();
     }
     delete dialog;
 }
@@ -175,7 +175,7 @@ void IncidenceAlarm::newAlarm()
         newAlarm->setEnabled(true);
         mAlarms.append(newAlarm);
         updateAlarmList();
-        checkDirtyStatus();
+        scheduleDirtyCheck();
     }
     delete dialog;
 }
@@ -189,7 +189,7 @@ void IncidenceAlarm::newAlarmFromPreset()
     }
 
     updateAlarmList();
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAlarm::removeCurrentAlarm()
@@ -201,7 +201,7 @@ void IncidenceAlarm::removeCurrentAlarm()
 
     updateAlarmList();
     updateButtons();
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAlarm::toggleCurrentAlarm()
@@ -213,7 +213,7 @@ void IncidenceAlarm::toggleCurrentAlarm()
 
     updateButtons();
     updateAlarmList();
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAlarm::updateAlarmList()
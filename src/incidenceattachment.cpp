@@ -139,7 +139,7 @@ void IncidenceAttachment::addAttachment()
     }
     delete dialog;
 
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAttachment::copyToClipboard()
@@ -211,7 +211,7 @@ void IncidenceAttachment::removeSelectedAttachments()
 
     mAttachmentView->update();
     Q_EMIT attachmentCountChanged(mAttachmentView->count());
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAttachment::saveAttachment(QListWidgetItem *item)
@@ -343,7 +343,7 @@ void IncidenceAttachment::slotItemRenamed(QListWidgetItem *item)
     Q_ASSERT(item);
     Q_ASSERT(dynamic_cast<AttachmentIconItem *>(item));
     static_cast<AttachmentIconItem *>(item)->setLabel(item->text());
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAttachment::slotSelectionChanged()
@@ -552,7 +552,7 @@ void IncidenceAttachment::addDataAttachment(const QByteArray &data, const QStrin
         item->setMimeType(mimeType);
     }
 
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceAttachment::addUriAttachment(const QString &uri, const QString &mimeType, const QString &label, bool inLine)
@@ -16,6 +16,7 @@
 #include "attendeelineeditdelegate.h"
 #include "attendeetablemodel.h"
 #include "conflictresolver.h"
+#include "contactgrouplookup.h"
 #include "editorconfig.h"
 #include "incidencedatetime.h"
 #include "schedulingdialog.h"
@@ -24,7 +25,6 @@
 
 #include <Akonadi/Contact/AbstractEmailAddressSelectionDialog>
 #include <Akonadi/Contact/ContactGroupExpandJob>
-#include <Akonadi/Contact/ContactGroupSearchJob>
 #include <Akonadi/Contact/EmailAddressSelectionDialog>
 
 #include <KCalUtils/Stringify>
@@ -40,6 +40,27 @@
 
 using namespace IncidenceEditorNG;
 
+// Hashes the fields Attendee::operator==() compares, except for the uid:
+// Attendee::uid() makes one up for attendees without one.
+static uint attendeeHash(const KCalendarCore::Attendee &attendee, uint seed)
+{
+    uint hash = qHash(attendee.email(), seed);
+    hash = qHash(attendee.name(), hash);
+    hash = qHash(attendee.delegate(), hash);
+    hash = qHash(attendee.delegator(), hash);
+    hash = qHash(static_cast<int>(attendee.role()), hash);
+    hash = qHash(static_cast<int>(attendee.status()), hash);
+    hash = qHash(static_cast<int>(attendee.cuType()), hash);
+    return qHash(attendee.RSVP(), hash);
+}
+
+// Two hashes with different seeds, so telling attendees apart by their key
+// is as good as comparing them.
+static quint64 attendeeKey(const KCalendarCore::Attendee &attendee)
+{
+    return (quint64(attendeeHash(attendee, 0)) << 32) | attendeeHash(attendee, 0x9e3779b9);
+}
+
 IncidenceAttendee::IncidenceAttendee(QWidget *parent, IncidenceDateTime *dateTime, Ui::EventOrTodoDesktop *ui)
     : mUi(ui)
     , mParentWidget(parent)
@@ -48,6 +69,9 @@ IncidenceAttendee::IncidenceAttendee(QWidget *parent, IncidenceDateTime *dateTim
     , mRoleDelegate(new AttendeeComboBoxDelegate(this))
     , mResponseDelegate(new AttendeeComboBoxDelegate(this))
 {
+    setDirtyCheck([this](uint changedFields) {
+        return isDirtyAfterChanges(changedFields);
+    });
     mDataModel = new AttendeeTableModel(this);
     mDataModel->setKeepEmpty(true);
     mDataModel->setRemoveEmptyLines(true);
@@ -107,7 +131,9 @@ IncidenceAttendee::IncidenceAttendee(QWidget *parent, IncidenceDateTime *dateTim
     connect(mUi->mOrganizerCombo, qOverload<const QString &>(&QComboBox::activated),
             this, &IncidenceAttendee::slotOrganizerChanged);
     */
-    connect(mUi->mOrganizerCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, &IncidenceAttendee::checkDirtyStatus);
+    connect(mUi->mOrganizerCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, [this]() {
+        fieldsChanged(OrganizerField);
+    });
 
     connect(mDateTime, &IncidenceDateTime::startDateChanged, this, &IncidenceAttendee::slotEventDurationChanged);
     connect(mDateTime, &IncidenceDateTime::endDateChanged, this, &IncidenceAttendee::slotEventDurationChanged);
@@ -122,6 +148,29 @@ IncidenceAttendee::IncidenceAttendee(QWidget *parent, IncidenceDateTime *dateTim
 
     slotUpdateConflictLabel(0); // initialize label
 
+    // Keep the hashes of the attendees up to date for areAttendeesDirty()
+    connect(mDataModel, &AttendeeTableModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        mAttendeeHashes.insert(first, last - first + 1, std::nullopt);
+        updateAttendeeHashes(first, last);
+    });
+    connect(mDataModel, &AttendeeTableModel::rowsRemoved, this, [this](const QModelIndex &, int first, int last) {
+        for (int i = first; i <= last; ++i) {
+            if (mAttendeeHashes.at(i)) {
+                balanceAttendee(*mAttendeeHashes.at(i), -1);
+            }
+        }
+        mAttendeeHashes.remove(first, last - first + 1);
+    });
+    connect(mDataModel, &AttendeeTableModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        // The availability is not part of the attendee
+        if (topLeft.column() != AttendeeTableModel::Available || bottomRight.column() != AttendeeTableModel::Available) {
+            updateAttendeeHashes(topLeft.row(), bottomRight.row());
+        }
+    });
+    connect(mDataModel, &AttendeeTableModel::layoutChanged, this, &IncidenceAttendee::resetAttendeeHashes);
+    connect(mDataModel, &AttendeeTableModel::modelReset, this, &IncidenceAttendee::resetAttendeeHashes);
+    resetAttendeeHashes();
+
     // conflict resolver (should show also resources)
     connect(mDataModel, &AttendeeTableModel::layoutChanged, this, &IncidenceAttendee::slotConflictResolverLayoutChanged);
     connect(mDataModel, &AttendeeTableModel::rowsAboutToBeRemoved, this, &IncidenceAttendee::slotConflictResolverAttendeeRemoved);
@@ -130,6 +179,7 @@ IncidenceAttendee::IncidenceAttendee(QWidget *parent, IncidenceDateTime *dateTim
 
     // Group substitution
     connect(filterProxyModel, &AttendeeFilterProxyModel::layoutChanged, this, &IncidenceAttendee::slotGroupSubstitutionLayoutChanged);
+    connect(ContactGroupLookup::instance(), &ContactGroupLookup::groupsFound, this, &IncidenceAttendee::groupSearchResult);
     connect(filterProxyModel, &AttendeeFilterProxyModel::rowsAboutToBeRemoved, this, &IncidenceAttendee::slotGroupSubstitutionAttendeeRemoved);
     connect(filterProxyModel, &AttendeeFilterProxyModel::rowsInserted, this, &IncidenceAttendee::slotGroupSubstitutionAttendeeAdded);
     connect(filterProxyModel, &AttendeeFilterProxyModel::dataChanged, this, &IncidenceAttendee::slotGroupSubstitutionAttendeeChanged);
@@ -150,6 +200,18 @@ void IncidenceAttendee::load(const KCalendarCore::Incidence::Ptr &incidence)
 {
     mLoadedIncidence = incidence;
 
+    // Start over with the attendees of the model against the new ones
+    mAttendeeBalance.clear();
+    for (const std::optional<quint64> &key : qAsConst(mAttendeeHashes)) {
+        if (key) {
+            balanceAttendee(*key, 1);
+        }
+    }
+    const KCalendarCore::Attendee::List originalAttendees = incidence->attendees();
+    for (const KCalendarCore::Attendee &attendee : originalAttendees) {
+        balanceAttendee(attendeeKey(attendee), -1);
+    }
+
     if (iAmOrganizer() || incidence->organizer().isEmpty()) {
         mUi->mOrganizerStack->setCurrentIndex(0);
 
@@ -189,6 +251,8 @@ void IncidenceAttendee::load(const KCalendarCore::Incidence::Ptr &incidence)
     setActions(incidence->type());
 
     mWasDirty = false;
+    mOrganizerDirty = false;
+    mAttendeesDirty = false;
 }
 
 void IncidenceAttendee::save(const KCalendarCore::Incidence::Ptr &incidence)
@@ -230,6 +294,22 @@ void IncidenceAttendee::save(const KCalendarCore::Incidence::Ptr &incidence)
 }
 
 bool IncidenceAttendee::isDirty() const
+{
+    return isOrganizerDirty() || areAttendeesDirty();
+}
+
+bool IncidenceAttendee::isDirtyAfterChanges(uint changedFields)
+{
+    if (changedFields & OrganizerField) {
+        mOrganizerDirty = isOrganizerDirty();
+    }
+    if (changedFields & AttendeesField) {
+        mAttendeesDirty = areAttendeesDirty();
+    }
+    return mOrganizerDirty || mAttendeesDirty;
+}
+
+bool IncidenceAttendee::isOrganizerDirty() const
 {
     if (iAmOrganizer()) {
         KCalendarCore::Event tmp;
@@ -241,42 +321,54 @@ bool IncidenceAttendee::isDirty() const
             return true;
         }
     }
+    return false;
+}
 
-    const KCalendarCore::Attendee::List originalList = mLoadedIncidence->attendees();
-    KCalendarCore::Attendee::List newList;
-
-    const auto lstAttendees = mDataModel->attendees();
-    for (const KCalendarCore::Attendee &attendee : lstAttendees) {
-        if (!attendee.fullName().isEmpty()) {
-            newList.append(attendee);
-        }
-    }
+bool IncidenceAttendee::areAttendeesDirty() const
+{
+    // Every attendee of the model is balanced out by an equal original one
+    // unless the lists differ. When the organizer is attending the event as
+    // well, he should be in the attendees list as well.
+    return !mAttendeeBalance.isEmpty();
+}
 
-    // The lists sizes *must* be the same. When the organizer is attending the
-    // event as well, he should be in the attendees list as well.
-    if (originalList.size() != newList.size()) {
-        return true;
+void IncidenceAttendee::balanceAttendee(quint64 key, int count)
+{
+    auto it = mAttendeeBalance.find(key);
+    if (it == mAttendeeBalance.end()) {
+        mAttendeeBalance.insert(key, count);
+    } else if ((*it += count) == 0) {
+        mAttendeeBalance.erase(it);
     }
+}
 
-    // Okay, again not the most efficient algorithm, but I'm assuming that in the
-    // bulk of the use cases, the number of attendees is not much higher than 10 or so.
-    for (const KCalendarCore::Attendee &attendee : originalList) {
-        bool found = false;
-        for (int i = 0; i < newList.count(); ++i) {
-            if (newList[i] == attendee) {
-                newList.remove(i);
-                found = true;
-                break;
-            }
+void IncidenceAttendee::updateAttendeeHashes(int first, int last)
+{
+    // attendees() is implicitly shared, this doesn't copy them
+    const KCalendarCore::Attendee::List attendees = mDataModel->attendees();
+    for (int i = first; i <= last && i < mAttendeeHashes.size(); ++i) {
+        std::optional<quint64> &key = mAttendeeHashes[i];
+        if (key) {
+            balanceAttendee(*key, -1);
         }
-
-        if (!found) {
-            // One of the attendees in the original list was not found in the new list.
-            return true;
+        key.reset();
+        if (!attendees.at(i).fullName().isEmpty()) {
+            key = attendeeKey(attendees.at(i));
+            balanceAttendee(*key, 1);
         }
     }
+}
 
-    return false;
+void IncidenceAttendee::resetAttendeeHashes()
+{
+    for (const std::optional<quint64> &key : qAsConst(mAttendeeHashes)) {
+        if (key) {
+            balanceAttendee(*key, -1);
+        }
+    }
+    mAttendeeHashes.clear();
+    mAttendeeHashes.resize(mDataModel->rowCount());
+    updateAttendeeHashes(0, mAttendeeHashes.size() - 1);
 }
 
 void IncidenceAttendee::changeStatusForMe(KCalendarCore::Attendee::PartStat stat)
@@ -293,7 +385,7 @@ void IncidenceAttendee::changeStatusForMe(KCalendarCore::Attendee::PartStat stat
         }
     }
 
-    checkDirtyStatus();
+    fieldsChanged(AttendeesField);
 }
 
 void IncidenceAttendee::acceptForMe()
@@ -323,47 +415,61 @@ void IncidenceAttendee::checkIfExpansionIsNeeded(const KCalendarCore::Attendee &
 {
     QString fullname = attendee.fullName();
 
-    // stop old job
-    KJob *oldJob = mMightBeGroupJobs.key(attendee.uid());
-    if (oldJob != nullptr) {
-        disconnect(oldJob);
-        oldJob->deleteLater();
-        mMightBeGroupJobs.remove(oldJob);
-    }
+    // forget about the old lookup
+    forgetGroupLookup(attendee.uid());
 
     mGroupList.remove(attendee.uid());
 
     if (!fullname.isEmpty()) {
-        auto job = new Akonadi::ContactGroupSearchJob();
-        job->setQuery(Akonadi::ContactGroupSearchJob::Name, fullname);
-        connect(job, &Akonadi::ContactGroupSearchJob::result, this, &IncidenceAttendee::groupSearchResult);
-
-        mMightBeGroupJobs.insert(job, attendee.uid());
+        mMightBeGroups[fullname].insert(attendee.uid());
+        mLookedUpNames.insert(attendee.uid(), fullname);
+        ContactGroupLookup::instance()->lookup(fullname);
     }
 }
 
-void IncidenceAttendee::groupSearchResult(KJob *job)
+void IncidenceAttendee::forgetGroupLookup(const QString &uid)
 {
-    auto searchJob = qobject_cast<Akonadi::ContactGroupSearchJob *>(job);
-    Q_ASSERT(searchJob);
+    const QString name = mLookedUpNames.take(uid);
+    if (name.isEmpty()) {
+        return;
+    }
+    auto it = mMightBeGroups.find(name);
+    if (it != mMightBeGroups.end()) {
+        it->remove(uid);
+        if (it->isEmpty()) {
+            mMightBeGroups.erase(it);
+        }
+    }
+}
 
-    Q_ASSERT(mMightBeGroupJobs.contains(job));
-    const auto uid = mMightBeGroupJobs.take(job);
+void IncidenceAttendee::groupSearchResult(const QString &name, const KContacts::ContactGroup::List &contactGroups)
+{
+    const QSet<QString> uids = mMightBeGroups.take(name);
+    if (uids.isEmpty()) {
+        return; // Looked up for another editor
+    }
+    for (const QString &uid : uids) {
+        mLookedUpNames.remove(uid);
+    }
 
-    const KContacts::ContactGroup::List contactGroups = searchJob->contactGroups();
     if (contactGroups.isEmpty()) {
         updateGroupExpand();
         return; // Nothing todo, probably a normal email address was entered
     }
 
     // TODO: Give the user the possibility to choose a group when there is more than one?!
-    KContacts::ContactGroup group = contactGroups.first();
+    const KContacts::ContactGroup group = contactGroups.first();
 
-    const int row = rowOfAttendee(uid);
-    QModelIndex index = dataModel()->index(row, AttendeeTableModel::CuType);
-    dataModel()->setData(index, KCalendarCore::Attendee::Group);
+    for (const QString &uid : uids) {
+        const int row = rowOfAttendee(uid);
+        if (row < 0) {
+            continue;
+        }
+        QModelIndex index = dataModel()->index(row, AttendeeTableModel::CuType);
+        dataModel()->setData(index, KCalendarCore::Attendee::Group);
 
-    mGroupList.insert(uid, group);
+        mGroupList.insert(uid, group);
+    }
     updateGroupExpand();
 }
 
@@ -389,6 +495,9 @@ void IncidenceAttendee::expandResult(KJob *job)
     Q_ASSERT(mExpandGroupJobs.contains(job));
     const auto uid = mExpandGroupJobs.take(job);
     const int row = rowOfAttendee(uid);
+    if (row < 0) {
+        return;
+    }
     const auto attendee = dataModel()->attendees().at(row);
     const QString currentEmail = attendee.email();
     const KContacts::Addressee::List groupMembers = expandJob->contacts();
@@ -402,18 +511,24 @@ void IncidenceAttendee::expandResult(KJob *job)
 
     if (!wasACorrectEmail) {
         dataModel()->removeRow(row);
+        KCalendarCore::Attendee::List members;
+        members.reserve(groupMembers.size());
         for (const KContacts::Addressee &member : groupMembers) {
-            KCalendarCore::Attendee newAt(member.realName(), member.preferredEmail(), attendee.RSVP(), attendee.status(), attendee.role(), member.uid());
-            dataModel()->insertAttendee(row, newAt);
+            members.append(KCalendarCore::Attendee(member.realName(), member.preferredEmail(), attendee.RSVP(), attendee.status(), attendee.role(), member.uid()));
         }
+        dataModel()->insertAttendees(row, members);
     }
 }
 
 void IncidenceAttendee::insertAddresses(const KContacts::Addressee::List &list)
 {
+    KCalendarCore::Attendee::List attendees;
+    attendees.reserve(list.size());
     for (const KContacts::Addressee &contact : list) {
-        insertAttendeeFromAddressee(contact);
+        attendees.append(attendeeFromAddressee(contact));
     }
+    // insert before the empty line
+    dataModel()->insertAttendees(qMax(dataModel()->rowCount() - 1, 0), attendees);
 }
 
 void IncidenceAttendee::slotSelectAddresses()
@@ -431,6 +546,7 @@ void IncidenceAttendee::slotSelectAddresses()
     connect(dialog.data(), &Akonadi::AbstractEmailAddressSelectionDialog::insertAddresses, this, &IncidenceEditorNG::IncidenceAttendee::insertAddresses);
     if (dialog->exec() == QDialog::Accepted) {
         const Akonadi::EmailAddressSelection::List list = dialog->selectedAddresses();
+        KContacts::Addressee::List contacts;
         for (const Akonadi::EmailAddressSelection &selection : list) {
             if (selection.item().hasPayload<KContacts::ContactGroup>()) {
                 auto job = new Akonadi::ContactGroupExpandJob(selection.item().payload<KContacts::ContactGroup>(), this);
@@ -452,9 +568,10 @@ void IncidenceAttendee::slotSelectAddresses()
                 if (selection.item().hasPayload<KContacts::Addressee>()) {
                     contact.setUid(selection.item().payload<KContacts::Addressee>().uid());
                 }
-                insertAttendeeFromAddressee(contact);
+                contacts.append(contact);
             }
         }
+        insertAddresses(contacts);
     }
     delete dialog;
 }
@@ -476,52 +593,57 @@ void IncidenceEditorNG::IncidenceAttendee::slotSolveConflictPressed()
 void IncidenceAttendee::slotConflictResolverAttendeeChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
     if (AttendeeTableModel::FullName <= bottomRight.column() && AttendeeTableModel::FullName >= topLeft.column()) {
-        for (int i = topLeft.row(); i <= bottomRight.row(); ++i) {
-            QModelIndex email = dataModel()->index(i, AttendeeTableModel::Email);
-            auto attendee = dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>();
-            if (mConflictResolver->containsAttendee(attendee)) {
-                mConflictResolver->removeAttendee(attendee);
-            }
-            if (!dataModel()->data(email).toString().isEmpty()) {
-                mConflictResolver->insertAttendee(attendee);
-            }
-        }
+        // The old values of the changed rows are gone, let the resolver
+        // find out which of its attendees are no longer there.
+        syncConflictResolver();
     }
-    checkDirtyStatus();
+    fieldsChanged(AttendeesField);
 }
 
 void IncidenceAttendee::slotConflictResolverAttendeeAdded(const QModelIndex &index, int first, int last)
 {
+    KCalendarCore::Attendee::List attendees;
+    attendees.reserve(last - first + 1);
     for (int i = first; i <= last; ++i) {
         QModelIndex email = dataModel()->index(i, AttendeeTableModel::Email, index);
         if (!dataModel()->data(email).toString().isEmpty()) {
-            mConflictResolver->insertAttendee(dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>());
+            attendees.append(dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>());
         }
     }
-    checkDirtyStatus();
+    mConflictResolver->insertAttendees(attendees);
+    fieldsChanged(AttendeesField);
 }
 
 void IncidenceAttendee::slotConflictResolverAttendeeRemoved(const QModelIndex &index, int first, int last)
 {
+    KCalendarCore::Attendee::List attendees;
     for (int i = first; i <= last; ++i) {
         QModelIndex email = dataModel()->index(i, AttendeeTableModel::Email, index);
         if (!dataModel()->data(email).toString().isEmpty()) {
-            mConflictResolver->removeAttendee(dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>());
+            attendees.append(dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>());
         }
     }
-    checkDirtyStatus();
+    mConflictResolver->removeAttendees(attendees);
+    fieldsChanged(AttendeesField);
 }
 
 void IncidenceAttendee::slotConflictResolverLayoutChanged()
+{
+    syncConflictResolver();
+    fieldsChanged(AttendeesField);
+}
+
+void IncidenceAttendee::syncConflictResolver()
 {
     const KCalendarCore::Attendee::List attendees = mDataModel->attendees();
-    mConflictResolver->clearAttendees();
+    KCalendarCore::Attendee::List withEmail;
+    withEmail.reserve(attendees.size());
     for (const KCalendarCore::Attendee &attendee : attendees) {
         if (!attendee.email().isEmpty()) {
-            mConflictResolver->insertAttendee(attendee);
+            withEmail.append(attendee);
         }
     }
-    checkDirtyStatus();
+    mConflictResolver->setAttendees(withEmail);
 }
 
 void IncidenceAttendee::slotFreeBusyAdded(const QModelIndex &parent, int first, int last)
@@ -530,15 +652,7 @@ void IncidenceAttendee::slotFreeBusyAdded(const QModelIndex &parent, int first,
     if (parent.isValid()) {
         return;
     }
-    QAbstractItemModel *model = mConflictResolver->model();
-    for (int i = first; i <= last; ++i) {
-        QModelIndex index = model->index(i, 0, parent);
-        const KCalendarCore::Attendee &attendee = model->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        const KCalendarCore::FreeBusy::Ptr &fb = model->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
-        if (!attendee.isNull()) {
-            updateFBStatus(attendee, fb);
-        }
-    }
+    updateFBStatus(first, last);
 }
 
 void IncidenceAttendee::slotFreeBusyChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
@@ -547,59 +661,42 @@ void IncidenceAttendee::slotFreeBusyChanged(const QModelIndex &topLeft, const QM
     if (topLeft.parent().isValid()) {
         return;
     }
-    QAbstractItemModel *model = mConflictResolver->model();
-    for (int i = topLeft.row(); i <= bottomRight.row(); ++i) {
-        QModelIndex index = model->index(i, 0);
-        const KCalendarCore::Attendee &attendee = model->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        const KCalendarCore::FreeBusy::Ptr &fb = model->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
-        if (!attendee.isNull()) {
-            updateFBStatus(attendee, fb);
-        }
-    }
+    updateFBStatus(topLeft.row(), bottomRight.row());
 }
 
 void IncidenceAttendee::updateFBStatus()
 {
+    updateFBStatus(0, mConflictResolver->model()->rowCount() - 1);
+}
+
+void IncidenceAttendee::updateFBStatus(int first, int last)
+{
+    const qint64 startTime = mDateTime->currentStartDateTime().toMSecsSinceEpoch();
+    const qint64 endTime = mDateTime->currentEndDateTime().toMSecsSinceEpoch();
+    QMap<int, AttendeeTableModel::AvailableStatus> available;
     QAbstractItemModel *model = mConflictResolver->model();
-    for (int i = 0; i < model->rowCount(); ++i) {
-        QModelIndex index = model->index(i, 0);
-        const KCalendarCore::Attendee &attendee = model->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        const KCalendarCore::FreeBusy::Ptr &fb = model->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
-        if (!attendee.isNull()) {
-            updateFBStatus(attendee, fb);
-        }
-    }
-}
-
-void IncidenceAttendee::updateFBStatus(const KCalendarCore::Attendee &attendee, const KCalendarCore::FreeBusy::Ptr &fb)
-{
-    KCalendarCore::Attendee::List attendees = mDataModel->attendees();
-    QDateTime startTime = mDateTime->currentStartDateTime();
-    QDateTime endTime = mDateTime->currentEndDateTime();
-    if (attendees.contains(attendee)) {
-        int row = dataModel()->attendees().indexOf(attendee);
-        QModelIndex attendeeIndex = dataModel()->index(row, AttendeeTableModel::Available);
-        if (fb) {
-            KCalendarCore::Period::List busyPeriods = fb->busyPeriods();
-            for (auto it = busyPeriods.begin(); it != busyPeriods.end(); ++it) {
-                // periods started before and lapping into the incidence (s < startTime && e >= startTime)
-                // periods starting in the time of incidence (s >= startTime && s <= endTime)
-                if (((*it).start() < startTime && (*it).end() > startTime) || ((*it).start() >= startTime && (*it).start() <= endTime)) {
-                    switch (attendee.status()) {
-                    case KCalendarCore::Attendee::Accepted:
-                        dataModel()->setData(attendeeIndex, AttendeeTableModel::Accepted);
-                        return;
-                    default:
-                        dataModel()->setData(attendeeIndex, AttendeeTableModel::Busy);
-                        return;
-                    }
-                }
-            }
-            dataModel()->setData(attendeeIndex, AttendeeTableModel::Free);
+    for (int i = first; i <= last; ++i) {
+        const QModelIndex index = model->index(i, 0);
+        const auto attendee = model->data(index, CalendarSupport::FreeBusyItemModel::AttendeeRole).value<KCalendarCore::Attendee>();
+        if (attendee.isNull()) {
+            continue;
+        }
+        const int row = mDataModel->rowOfAttendee(attendee);
+        if (row < 0) {
+            continue;
+        }
+
+        const auto fb = model->data(index, CalendarSupport::FreeBusyItemModel::FreeBusyRole).value<KCalendarCore::FreeBusy::Ptr>();
+        if (!fb) {
+            available.insert(row, AttendeeTableModel::Unknown);
+        } else if (mConflictResolver->busyIntervals(fb).intersects(startTime, endTime)) {
+            // periods started before and lapping into the incidence, or starting in the time of incidence
+            available.insert(row, attendee.status() == KCalendarCore::Attendee::Accepted ? AttendeeTableModel::Accepted : AttendeeTableModel::Busy);
         } else {
-            dataModel()->setData(attendeeIndex, AttendeeTableModel::Unknown);
+            available.insert(row, AttendeeTableModel::Free);
         }
     }
+    mDataModel->setAvailable(available);
 }
 
 void IncidenceAttendee::slotUpdateConflictLabel(int count)
@@ -648,13 +745,8 @@ void IncidenceAttendee::slotGroupSubstitutionAttendeeRemoved(const QModelIndex &
     for (int i = first; i <= last; ++i) {
         QModelIndex email = dataModel()->index(i, AttendeeTableModel::Email);
         auto attendee = dataModel()->data(email, AttendeeTableModel::AttendeeRole).value<KCalendarCore::Attendee>();
-        KJob *job = mMightBeGroupJobs.key(attendee.uid());
-        if (job) {
-            disconnect(job);
-            job->deleteLater();
-            mMightBeGroupJobs.remove(job);
-        }
-        job = mExpandGroupJobs.key(attendee.uid());
+        forgetGroupLookup(attendee.uid());
+        KJob *job = mExpandGroupJobs.key(attendee.uid());
         if (job) {
             disconnect(job);
             job->deleteLater();
@@ -667,18 +759,13 @@ void IncidenceAttendee::slotGroupSubstitutionAttendeeRemoved(const QModelIndex &
 
 void IncidenceAttendee::slotGroupSubstitutionLayoutChanged()
 {
-    for (auto it = mMightBeGroupJobs.cbegin(), end = mMightBeGroupJobs.cend(); it != end; ++it) {
-        KJob *job = it.key();
-        disconnect(job);
-        job->deleteLater();
-    }
-
     for (auto it = mExpandGroupJobs.cbegin(), end = mExpandGroupJobs.cend(); it != end; ++it) {
         KJob *job = it.key();
         disconnect(job);
         job->deleteLater();
     }
-    mMightBeGroupJobs.clear();
+    mMightBeGroups.clear();
+    mLookedUpNames.clear();
     mExpandGroupJobs.clear();
     mGroupList.clear();
 
@@ -708,7 +795,7 @@ bool IncidenceAttendee::iAmOrganizer() const
     return true;
 }
 
-void IncidenceAttendee::insertAttendeeFromAddressee(const KContacts::Addressee &a, int pos /*=-1*/)
+KCalendarCore::Attendee IncidenceAttendee::attendeeFromAddressee(const KContacts::Addressee &a) const
 {
     const bool sameAsOrganizer = mUi->mOrganizerCombo && KEmailAddress::compareEmail(a.preferredEmail(), mUi->mOrganizerCombo->currentText(), false);
     KCalendarCore::Attendee::PartStat partStat = KCalendarCore::Attendee::NeedsAction;
@@ -718,12 +805,7 @@ void IncidenceAttendee::insertAttendeeFromAddressee(const KContacts::Addressee &
         partStat = KCalendarCore::Attendee::Accepted;
         rsvp = false;
     }
-    KCalendarCore::Attendee newAt(a.realName(), a.preferredEmail(), rsvp, partStat, KCalendarCore::Attendee::ReqParticipant, a.uid());
-    if (pos < 0) {
-        pos = dataModel()->rowCount() - 1;
-    }
-
-    dataModel()->insertAttendee(pos, newAt);
+    return KCalendarCore::Attendee(a.realName(), a.preferredEmail(), rsvp, partStat, KCalendarCore::Attendee::ReqParticipant, a.uid());
 }
 
 void IncidenceAttendee::slotEventDurationChanged()
@@ -840,7 +922,7 @@ void IncidenceAttendee::updateCount()
 {
     Q_EMIT attendeeCountChanged(attendeeCount());
 
-    checkDirtyStatus();
+    fieldsChanged(AttendeesField);
 }
 
 int IncidenceAttendee::attendeeCount() const
@@ -932,9 +1014,5 @@ void IncidenceAttendee::printDebugInfo() const
 
 int IncidenceAttendee::rowOfAttendee(const QString &uid) const
 {
-    const auto attendees = dataModel()->attendees();
-    const auto it = std::find_if(attendees.begin(), attendees.end(), [uid](const KCalendarCore::Attendee &att) {
-        return att.uid() == uid;
-    });
-    return std::distance(attendees.begin(), it);
+    return dataModel()->rowOfUid(uid);
 }
@@ -11,16 +11,19 @@
 
 #include <KCalendarCore/FreeBusy>
 #include <KContacts/Addressee>
+#include <KContacts/ContactGroup>
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include <optional>
+
 namespace Ui
 {
 class EventOrTodoDesktop;
 }
 
-namespace KContacts
-{
-class Addressee;
-class ContactGroup;
-}
 
 class KJob;
 
@@ -67,8 +70,8 @@ private Q_SLOTS:
     // cheks if row is a group,  that can/should be expanded
     void checkIfExpansionIsNeeded(const KCalendarCore::Attendee &attendee);
 
-    // results of the group search job
-    void groupSearchResult(KJob *job);
+    // results of the group lookup
+    void groupSearchResult(const QString &name, const KContacts::ContactGroup::List &contactGroups);
     void expandResult(KJob *job);
     void slotSelectAddresses();
     void slotSolveConflictPressed();
@@ -89,7 +92,6 @@ private Q_SLOTS:
     void slotFreeBusyAdded(const QModelIndex &index, int first, int last);
     void slotFreeBusyChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
     void updateFBStatus();
-    void updateFBStatus(const KCalendarCore::Attendee &attendee, const KCalendarCore::FreeBusy::Ptr &fb);
 
     void slotGroupSubstitutionAttendeeAdded(const QModelIndex &index, int first, int last);
     void slotGroupSubstitutionAttendeeRemoved(const QModelIndex &index, int first, int last);
@@ -97,7 +99,41 @@ private Q_SLOTS:
     void slotGroupSubstitutionLayoutChanged();
 
 private:
+    enum Field : uint { OrganizerField = 0x1, AttendeesField = 0x2 };
+
+    Q_REQUIRED_RESULT bool isDirtyAfterChanges(uint changedFields);
+
+    Q_REQUIRED_RESULT bool isOrganizerDirty() const;
+    Q_REQUIRED_RESULT bool areAttendeesDirty() const;
+
+    /**
+     * Adds @p count to the balance of the attendees with @p key.
+     */
+    void balanceAttendee(quint64 key, int count);
+    /**
+     * Updates the keys of the attendees in the rows @p first to @p last of
+     * the data model, along with their balance.
+     */
+    void updateAttendeeHashes(int first, int last);
+    void resetAttendeeHashes();
+
     void updateGroupExpand();
+    /**
+     * Drops the attendee with @p uid from the pending contact group lookups.
+     */
+    void forgetGroupLookup(const QString &uid);
+
+    /**
+     * Makes the attendees with an email the attendees of the conflict
+     * resolver, only adding and removing the ones which changed.
+     */
+    void syncConflictResolver();
+
+    /**
+     * Updates the availability of the attendees in the rows @p first to
+     * @p last of the free/busy model at once.
+     */
+    void updateFBStatus(int first, int last);
 
     void insertAddresses(const KContacts::Addressee::List &list);
 
@@ -106,14 +142,11 @@ private:
     /** Returns if I was the organizer of the loaded event */
     bool iAmOrganizer() const;
 
-    /** Reads values from a KContacts::Addressee and inserts a new Attendee
-     * item into the listview with those items. Used when adding attendees
-     * from the addressbook and expanding distribution lists.
-     * The optional Attendee parameter can be used to pass in default values
-     * to be used by the new Attendee.
-     * pos =-1 means insert attendee before empty line
+    /** Reads values from a KContacts::Addressee and returns a new Attendee
+     * with those items, to be inserted into the listview. Used when adding
+     * attendees from the addressbook.
      */
-    void insertAttendeeFromAddressee(const KContacts::Addressee &a, int pos = -1);
+    KCalendarCore::Attendee attendeeFromAddressee(const KContacts::Addressee &a) const;
     void fillOrganizerCombo();
     void setActions(KCalendarCore::Incidence::IncidenceType actions);
 
@@ -133,9 +166,19 @@ private:
     AttendeeComboBoxDelegate *mRoleDelegate = nullptr;
     AttendeeComboBoxDelegate *mResponseDelegate = nullptr;
 
+    /** the key of the attendee in each row of mDataModel, none for empty rows */
+    QVector<std::optional<quint64>> mAttendeeHashes;
+    /**
+     * the number of attendees in mDataModel minus the number of attendees of
+     * the loaded incidence, by key, without the ones which balance out
+     */
+    QHash<quint64, int> mAttendeeBalance;
+    bool mOrganizerDirty = false;
+    bool mAttendeesDirty = false;
     // the QString is Attendee::uid here
     QMap<QString, KContacts::ContactGroup> mGroupList;
-    QMap<KJob *, QString> mMightBeGroupJobs;
+    QHash<QString, QSet<QString>> mMightBeGroups; //!< the Attendee::uids waiting for a lookup, by name
+    QHash<QString, QString> mLookedUpNames; //!< the names looked up, by Attendee::uid
     QMap<KJob *, QString> mExpandGroupJobs;
 };
 }
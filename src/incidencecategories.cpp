@@ -31,7 +31,7 @@ void IncidenceCategories::onSelectionChanged(const Akonadi::Tag::List &list)
 {
     Q_UNUSED(list)
     mDirty = true;
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceCategories::load(const KCalendarCore::Incidence::Ptr &incidence)
@@ -37,7 +37,7 @@ void IncidenceCompletionPriority::Private::sliderValueChanged(int value)
     }
 
     mUi->mCompletedLabel->setText(QStringLiteral("%1%").arg(value));
-    q->checkDirtyStatus();
+    q->scheduleDirtyCheck();
 }
 
 IncidenceCompletionPriority::IncidenceCompletionPriority(Ui::EventOrTodoDesktop *ui)
@@ -59,7 +59,7 @@ IncidenceCompletionPriority::IncidenceCompletionPriority(Ui::EventOrTodoDesktop
     connect(d->mUi->mCompletionSlider, qOverload<int>(&QSlider::valueChanged), this, [this](int val) {
         d->sliderValueChanged(val);
     });
-    connect(d->mUi->mPriorityCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, &IncidenceCompletionPriority::checkDirtyStatus);
+    connect(d->mUi->mPriorityCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, &IncidenceCompletionPriority::scheduleDirtyCheck);
 }
 
 IncidenceCompletionPriority::~IncidenceCompletionPriority()
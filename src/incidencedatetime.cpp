@@ -76,9 +76,9 @@ IncidenceDateTime::IncidenceDateTime(Ui::EventOrTodoDesktop *ui)
         }
     }
 
-    connect(mUi->mFreeBusyCheck, &QCheckBox::toggled, this, &IncidenceDateTime::checkDirtyStatus);
+    connect(mUi->mFreeBusyCheck, &QCheckBox::toggled, this, &IncidenceDateTime::scheduleDirtyCheck);
     connect(mUi->mWholeDayCheck, &QCheckBox::toggled, this, &IncidenceDateTime::enableTimeEdits);
-    connect(mUi->mWholeDayCheck, &QCheckBox::toggled, this, &IncidenceDateTime::checkDirtyStatus);
+    connect(mUi->mWholeDayCheck, &QCheckBox::toggled, this, &IncidenceDateTime::scheduleDirtyCheck);
 
     connect(this, &IncidenceDateTime::startDateChanged, this, &IncidenceDateTime::updateStartToolTips);
     connect(this, &IncidenceDateTime::startTimeChanged, this, &IncidenceDateTime::updateStartToolTips);
@@ -253,7 +253,7 @@ void IncidenceDateTime::updateStartTime(const QTime &newTime)
     }
 
     Q_EMIT startTimeChanged(mCurrentStartDateTime.time());
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceDateTime::updateStartDate(const QDate &newDate)
@@ -274,7 +274,7 @@ void IncidenceDateTime::updateStartDate(const QDate &newDate)
         mUi->mEndDateEdit->setDate(endDateTime.date());
     }
 
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 
     if (dateChanged) {
         Q_EMIT startDateChanged(mCurrentStartDateTime.date());
@@ -298,7 +298,7 @@ void IncidenceDateTime::updateStartSpec()
     }
 
     if (type() == KCalendarCore::Incidence::TypeJournal) {
-        checkDirtyStatus();
+        scheduleDirtyCheck();
     }
 }
 
@@ -326,7 +326,7 @@ void IncidenceDateTime::enableStartEdit(bool enable)
     }
 
     mUi->mTimeZoneComboStart->setFloating(!mUi->mTimeZoneComboStart->isEnabled());
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceDateTime::enableEndEdit(bool enable)
@@ -351,7 +351,7 @@ void IncidenceDateTime::enableEndEdit(bool enable)
     }
 
     mUi->mTimeZoneComboEnd->setFloating(!mUi->mTimeZoneComboEnd->isEnabled());
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 bool IncidenceDateTime::timeZonesAreLocal(const QDateTime &start, const QDateTime &end)
@@ -521,16 +521,16 @@ void IncidenceDateTime::load(const KCalendarCore::Event::Ptr &event, bool isTemp
             &IncidenceDateTime::updateStartSpec);
 
     // End time
-    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::checkDirtyStatus);
-    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::checkDirtyStatus);
-    connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::checkDirtyStatus);
+    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::scheduleDirtyCheck);
+    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::scheduleDirtyCheck);
+    connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::scheduleDirtyCheck);
     connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::endTimeChanged);
     connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::endTimeChanged);
     connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::endDateChanged);
     connect(mUi->mTimeZoneComboEnd,
             static_cast<void (IncidenceEditorNG::KTimeZoneComboBox::*)(int)>(&IncidenceEditorNG::KTimeZoneComboBox::currentIndexChanged),
             this,
-            &IncidenceDateTime::checkDirtyStatus);
+            &IncidenceDateTime::scheduleDirtyCheck);
     mUi->mWholeDayCheck->setChecked(event->allDay());
     enableTimeEdits();
 
@@ -630,16 +630,16 @@ void IncidenceDateTime::load(const KCalendarCore::Todo::Ptr &todo, bool isTempla
 
     connect(mUi->mEndCheck, &QCheckBox::toggled, this, &IncidenceDateTime::enableEndEdit);
     connect(mUi->mEndCheck, &QCheckBox::toggled, this, &IncidenceDateTime::endDateTimeToggled);
-    connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::checkDirtyStatus);
-    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::checkDirtyStatus);
-    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::checkDirtyStatus);
+    connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::scheduleDirtyCheck);
+    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::scheduleDirtyCheck);
+    connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::scheduleDirtyCheck);
     connect(mUi->mEndDateEdit, &KDateComboBox::dateChanged, this, &IncidenceDateTime::endDateChanged);
     connect(mUi->mEndTimeEdit, &KTimeComboBox::timeChanged, this, &IncidenceDateTime::endTimeChanged);
     connect(mUi->mEndTimeEdit, &KTimeComboBox::timeEdited, this, &IncidenceDateTime::endTimeChanged);
     connect(mUi->mTimeZoneComboEnd,
             static_cast<void (IncidenceEditorNG::KTimeZoneComboBox::*)(int)>(&IncidenceEditorNG::KTimeZoneComboBox::currentIndexChanged),
             this,
-            &IncidenceDateTime::checkDirtyStatus);
+            &IncidenceDateTime::scheduleDirtyCheck);
     const QDateTime rightNow = QDateTime::currentDateTime();
 
     if (isTemplate) {
@@ -39,7 +39,7 @@ IncidenceDescription::IncidenceDescription(Ui::EventOrTodoDesktop *ui)
     mUi->mRichTextLabel->setContextMenuPolicy(Qt::NoContextMenu);
     setupToolBar();
     connect(mUi->mRichTextLabel, &QLabel::linkActivated, this, &IncidenceDescription::toggleRichTextDescription);
-    connect(mUi->mDescriptionEdit->richTextComposer(), &KPIMTextEdit::RichTextComposer::textChanged, this, &IncidenceDescription::checkDirtyStatus);
+    connect(mUi->mDescriptionEdit->richTextComposer(), &KPIMTextEdit::RichTextComposer::textChanged, this, &IncidenceDescription::scheduleDirtyCheck);
 }
 
 IncidenceDescription::~IncidenceDescription()
@@ -118,7 +118,7 @@ void IncidenceDescription::enableRichTextDescription(bool enable)
     mUi->mRichTextLabel->setText(placeholder);
     mUi->mDescriptionEdit->richTextComposer()->setEnableActions(enable);
     mUi->mEditToolBarPlaceHolder->setVisible(enable);
-    checkDirtyStatus();
+    scheduleDirtyCheck();
 }
 
 void IncidenceDescription::toggleRichTextDescription()
@@ -8,6 +8,7 @@
 
 #include "incidencedialog.h"
 #include "combinedincidenceeditor.h"
+#include "deferredincidenceeditor.h"
 #include "editorconfig.h"
 #include "incidencealarm.h"
 #include "incidenceattachment.h"
@@ -44,6 +45,7 @@
 #include <QCloseEvent>
 #include <QDir>
 #include <QIcon>
+#include <QMetaMethod>
 #include <QStandardPaths>
 #include <QTimeZone>
 
@@ -63,12 +65,15 @@ public:
     Akonadi::CollectionComboBox *mCalSelector = nullptr;
     bool mCloseOnSave = false;
 
+    Akonadi::IncidenceChanger *mChanger = nullptr;
     EditorItemManager *mItemManager = nullptr;
     CombinedIncidenceEditor *mEditor = nullptr;
     IncidenceDateTime *mIeDateTime = nullptr;
-    IncidenceAttendee *mIeAttendee = nullptr;
+    // The editors of the heavier tabs are only created once their tab is shown
+    DeferredIncidenceEditor *mIeAttachments = nullptr;
+    DeferredIncidenceEditor *mIeAttendee = nullptr;
     IncidenceRecurrence *mIeRecurrence = nullptr;
-    IncidenceResource *mIeResource = nullptr;
+    DeferredIncidenceEditor *mIeResource = nullptr;
     bool mInitiallyDirty = false;
     Akonadi::Item mItem;
     Q_REQUIRED_RESULT QString typeToString(const int type) const;
@@ -78,6 +83,11 @@ public:
     ~IncidenceDialogPrivate() override;
 
     /// General methods
+    IncidenceAttendee *attendeeEditor();
+    void createItemManager();
+    void reset();
+    void handleCurrentTabChange(int index);
+    void materializeEditors();
     void handleAlarmCountChange(int newCount);
     void handleRecurrenceChange(IncidenceEditorNG::RecurrenceType type);
     void loadTemplate(const QString &templateName);
@@ -111,7 +121,7 @@ IncidenceDialogPrivate::IncidenceDialogPrivate(Akonadi::IncidenceChanger *change
     : q_ptr(qq)
     , mUi(new Ui::EventOrTodoDesktop)
     , mCalSelector(new Akonadi::CollectionComboBox(changer ? changer->entityTreeModel() : nullptr))
-    , mItemManager(new EditorItemManager(this, changer))
+    , mChanger(changer)
     , mEditor(new CombinedIncidenceEditor(qq))
 {
     Q_Q(IncidenceDialog);
@@ -145,22 +155,41 @@ IncidenceDialogPrivate::IncidenceDialogPrivate(Akonadi::IncidenceChanger *change
     auto ieAlarm = new IncidenceAlarm(mIeDateTime, mUi);
     mEditor->combine(ieAlarm);
 
-    auto ieAttachments = new IncidenceAttachment(mUi);
-    mEditor->combine(ieAttachments);
+    mIeAttachments = new DeferredIncidenceEditor([this, qq]() {
+        auto ieAttachments = new IncidenceAttachment(mUi);
+        qq->connect(ieAttachments, SIGNAL(attachmentCountChanged(int)), SLOT(updateAttachmentCount(int)));
+        return ieAttachments;
+    });
+    mEditor->combine(mIeAttachments);
 
+    // Not deferred: the recurrence has to follow changes of the start date
+    // even while its tab was never shown.
     mIeRecurrence = new IncidenceRecurrence(mIeDateTime, mUi);
     mEditor->combine(mIeRecurrence);
 
     auto ieSecrecy = new IncidenceSecrecy(mUi);
     mEditor->combine(ieSecrecy);
 
-    mIeAttendee = new IncidenceAttendee(qq, mIeDateTime, mUi);
-    mIeAttendee->setParent(qq);
+    mIeAttendee = new DeferredIncidenceEditor([this, qq]() {
+        auto ieAttendee = new IncidenceAttendee(qq, mIeDateTime, mUi);
+        ieAttendee->setParent(qq);
+        qq->connect(ieAttendee, SIGNAL(attendeeCountChanged(int)), SLOT(updateAttendeeCount(int)));
+        return ieAttendee;
+    });
     mEditor->combine(mIeAttendee);
 
-    mIeResource = new IncidenceResource(mIeAttendee, mIeDateTime, mUi);
+    // The resources are attendees as well, kept in the model of the attendee editor
+    mIeResource = new DeferredIncidenceEditor([this, qq]() {
+        auto ieResource = new IncidenceResource(attendeeEditor(), mIeDateTime, mUi);
+        qq->connect(ieResource, SIGNAL(resourceCountChanged(int)), SLOT(updateResourceCount(int)));
+        return ieResource;
+    });
     mEditor->combine(mIeResource);
 
+    q->connect(mUi->mTabWidget, &QTabWidget::currentChanged, q, [this](int index) {
+        handleCurrentTabChange(index);
+    });
+
     // Set the default collection
     const qint64 colId = CalendarSupport::KCalPrefs::instance()->defaultCalendarId();
     const Akonadi::Collection col(colId);
@@ -168,24 +197,88 @@ IncidenceDialogPrivate::IncidenceDialogPrivate(Akonadi::IncidenceChanger *change
 
     q->connect(mEditor, SIGNAL(showMessage(QString, KMessageWidget::MessageType)), SLOT(showMessage(QString, KMessageWidget::MessageType)));
     q->connect(mEditor, SIGNAL(dirtyStatusChanged(bool)), SLOT(updateButtonStatus(bool)));
+    createItemManager();
+    q->connect(ieAlarm, SIGNAL(alarmCountChanged(int)), SLOT(handleAlarmCountChange(int)));
+    q->connect(mIeRecurrence, SIGNAL(recurrenceChanged(IncidenceEditorNG::RecurrenceType)), SLOT(handleRecurrenceChange(IncidenceEditorNG::RecurrenceType)));
+}
+
+IncidenceDialogPrivate::~IncidenceDialogPrivate()
+{
+    delete mItemManager;
+    delete mEditor;
+    delete mUi;
+}
+
+void IncidenceDialogPrivate::createItemManager()
+{
+    Q_Q(IncidenceDialog);
+    mItemManager = new EditorItemManager(this, mChanger);
     q->connect(mItemManager,
                SIGNAL(itemSaveFinished(IncidenceEditorNG::EditorItemManager::SaveAction)),
                SLOT(handleItemSaveFinish(IncidenceEditorNG::EditorItemManager::SaveAction)));
     q->connect(mItemManager,
                SIGNAL(itemSaveFailed(IncidenceEditorNG::EditorItemManager::SaveAction, QString)),
                SLOT(handleItemSaveFail(IncidenceEditorNG::EditorItemManager::SaveAction, QString)));
-    q->connect(ieAlarm, SIGNAL(alarmCountChanged(int)), SLOT(handleAlarmCountChange(int)));
-    q->connect(mIeRecurrence, SIGNAL(recurrenceChanged(IncidenceEditorNG::RecurrenceType)), SLOT(handleRecurrenceChange(IncidenceEditorNG::RecurrenceType)));
-    q->connect(ieAttachments, SIGNAL(attachmentCountChanged(int)), SLOT(updateAttachmentCount(int)));
-    q->connect(mIeAttendee, SIGNAL(attendeeCountChanged(int)), SLOT(updateAttendeeCount(int)));
-    q->connect(mIeResource, SIGNAL(resourceCountChanged(int)), SLOT(updateResourceCount(int)));
 }
 
-IncidenceDialogPrivate::~IncidenceDialogPrivate()
+void IncidenceDialogPrivate::reset()
 {
+    // A new item manager drops the loaded item, its monitor and the counter
+    // proposal flag.
     delete mItemManager;
-    delete mEditor;
-    delete mUi;
+    createItemManager();
+
+    mEditor->reset();
+    mItem = Akonadi::Item();
+    mInitiallyDirty = false;
+    mCloseOnSave = false;
+
+    // load() removes these tabs for journals, their titles are set by load()
+    const QVector<QPair<int, QWidget *>> tabs = {{AttendeesTab, mUi->mAttendeesTab},
+                                                 {ResourcesTab, mUi->mResourceTab},
+                                                 {AlarmsTab, mUi->mReminderTab},
+                                                 {RecurrenceTab, mUi->mRecurrenceTab},
+                                                 {AttachmentsTab, mUi->mAttachmentsTab}};
+    for (const auto &tab : tabs) {
+        if (mUi->mTabWidget->indexOf(tab.second) < 0) {
+            mUi->mTabWidget->insertTab(tab.first, tab.second, QString());
+        }
+    }
+    mUi->mTabWidget->setCurrentIndex(GeneralTab);
+
+    mUi->mMessageWidget->hide();
+    mUi->mInvitationBar->hide();
+    mUi->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+    mUi->buttonBox->button(QDialogButtonBox::Cancel)->setEnabled(true);
+    mUi->buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
+
+    mIeDateTime->setActiveDate(QDate());
+    setCalendarCollection(Akonadi::Collection(CalendarSupport::KCalPrefs::instance()->defaultCalendarId()));
+}
+
+IncidenceAttendee *IncidenceDialogPrivate::attendeeEditor()
+{
+    return static_cast<IncidenceAttendee *>(mIeAttendee->materialize());
+}
+
+void IncidenceDialogPrivate::handleCurrentTabChange(int index)
+{
+    // Tabs get removed for journals, so go by the page instead of the index
+    const QWidget *page = mUi->mTabWidget->widget(index);
+    if (page == mUi->mAttendeesTab) {
+        mIeAttendee->materialize();
+    } else if (page == mUi->mResourceTab) {
+        mIeResource->materialize();
+    } else if (page == mUi->mAttachmentsTab) {
+        mIeAttachments->materialize();
+    }
+}
+
+void IncidenceDialogPrivate::materializeEditors()
+{
+    mIeAttachments->materialize();
+    mIeAttendee->materialize();
+    mIeResource->materialize();
 }
 
 void IncidenceDialogPrivate::slotInvalidCollection()
@@ -327,6 +420,10 @@ void IncidenceDialogPrivate::saveTemplate(const QString &templateName)
 
     KCalendarCore::MemoryCalendar::Ptr cal(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
 
+    // The template is saved into a new incidence, so the editors which were not
+    // created yet have to be, to save the values they keep.
+    materializeEditors();
+
     switch (mEditor->type()) {
     case KCalendarCore::Incidence::TypeEvent: {
         KCalendarCore::Event::Ptr event(new KCalendarCore::Event());
@@ -490,6 +587,24 @@ void IncidenceDialogPrivate::handleItemSaveFinish(EditorItemManager::SaveAction
     }
 }
 
+/**
+ * Returns the number of attendees of @p incidence shown in the attendee tab,
+ * or in the resource tab if @p resources is true, the way the editors of these
+ * tabs count them.
+ */
+static int attendeeCount(const KCalendarCore::Incidence::Ptr &incidence, bool resources)
+{
+    int count = 0;
+    const KCalendarCore::Attendee::List attendees = incidence->attendees();
+    for (const KCalendarCore::Attendee &attendee : attendees) {
+        const bool isResource = attendee.cuType() == KCalendarCore::Attendee::Resource || attendee.cuType() == KCalendarCore::Attendee::Room;
+        if (isResource == resources && !attendee.fullName().isEmpty()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
 bool IncidenceDialogPrivate::hasSupportedPayload(const Akonadi::Item &item) const
 {
     return CalendarSupport::incidence(item);
@@ -572,8 +687,8 @@ void IncidenceDialogPrivate::load(const Akonadi::Item &item)
 
     // Initialize tab's titles
     updateAttachmentCount(incidence->attachments().size());
-    updateResourceCount(mIeResource->resourceCount());
-    updateAttendeeCount(mIeAttendee->attendeeCount());
+    updateResourceCount(attendeeCount(incidence, true));
+    updateAttendeeCount(attendeeCount(incidence, false));
     handleRecurrenceChange(mIeRecurrence->currentRecurrenceType());
     handleAlarmCountChange(incidence->alarms().count());
 
@@ -659,9 +774,13 @@ IncidenceDialog::IncidenceDialog(Akonadi::IncidenceChanger *changer, QWidget *pa
 
     setModal(false);
 
-    connect(d->mUi->mAcceptInvitationButton, &QAbstractButton::clicked, d->mIeAttendee, &IncidenceAttendee::acceptForMe);
+    connect(d->mUi->mAcceptInvitationButton, &QAbstractButton::clicked, this, [d]() {
+        d->attendeeEditor()->acceptForMe();
+    });
     connect(d->mUi->mAcceptInvitationButton, &QAbstractButton::clicked, d->mUi->mInvitationBar, &QWidget::hide);
-    connect(d->mUi->mDeclineInvitationButton, &QAbstractButton::clicked, d->mIeAttendee, &IncidenceAttendee::declineForMe);
+    connect(d->mUi->mDeclineInvitationButton, &QAbstractButton::clicked, this, [d]() {
+        d->attendeeEditor()->declineForMe();
+    });
     connect(d->mUi->mDeclineInvitationButton, &QAbstractButton::clicked, d->mUi->mInvitationBar, &QWidget::hide);
     connect(this, SIGNAL(invalidCollection()), this, SLOT(slotInvalidCollection()));
     readConfig();
@@ -703,6 +822,29 @@ void IncidenceDialog::load(const Akonadi::Item &item, const QDate &activeDate)
     }
 }
 
+void IncidenceDialog::reset()
+{
+    Q_D(IncidenceDialog);
+    // Keep the size the user gave the dialog, as the destructor would
+    writeConfig();
+    d->reset();
+
+    // Drop whoever the previous user connected to the dialog, but leave
+    // destroyed() and objectNameChanged() alone, Qt itself tracks objects
+    // through these.
+    const QMetaObject *metaObject = this->metaObject();
+    for (int i = QObject::staticMetaObject.methodCount(); i < metaObject->methodCount(); ++i) {
+        const QMetaMethod method = metaObject->method(i);
+        if (method.methodType() == QMetaMethod::Signal) {
+            QObject::disconnect(this, method, nullptr, QMetaMethod());
+        }
+    }
+    connect(this, SIGNAL(invalidCollection()), this, SLOT(slotInvalidCollection()));
+
+    setAttribute(Qt::WA_DeleteOnClose);
+    d->mUi->mSummaryEdit->setFocus();
+}
+
 void IncidenceDialog::selectCollection(const Akonadi::Collection &collection)
 {
     Q_D(IncidenceDialog);
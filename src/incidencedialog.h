@@ -53,6 +53,15 @@ public:
 
     virtual void setIsCounterProposal(bool isCounterProposal);
 
+    /**
+     * Brings the dialog back to the state it had right after construction,
+     * so that another item can be loaded into it. The widgets and editors are
+     * kept, they get their values from the next load(). Connections made to
+     * the signals of the dialog are dropped, they were made for the previous
+     * item; the ones to the signals inherited from QObject are kept.
+     */
+    void reset();
+
     /**
       Returns the object that will receive all key events.
     */
@@ -6,8 +6,10 @@
 */
 
 #include "incidencedialogfactory.h"
+#include "freebusycache.h"
 #include "incidencedefaults.h"
 #include "incidencedialog.h"
+#include "incidencedialogpool.h"
 
 #include <Akonadi/Calendar/IncidenceChanger>
 #include <Item>
@@ -27,7 +29,7 @@ IncidenceDialog *IncidenceDialogFactory::create(bool needsSaving,
     case KCalendarCore::IncidenceBase::TypeEvent: // Fall through
     case KCalendarCore::IncidenceBase::TypeTodo:
     case KCalendarCore::IncidenceBase::TypeJournal: {
-        auto dialog = new IncidenceDialog(changer, parent, flags);
+        auto dialog = IncidenceDialogPool::instance()->create(changer, parent, flags);
 
         // needs to be save to akonadi?, apply button should be turned on if so.
         dialog->setInitiallyDirty(needsSaving /* mInitiallyDirty */);
@@ -39,6 +41,16 @@ IncidenceDialog *IncidenceDialogFactory::create(bool needsSaving,
     }
 }
 
+void IncidenceDialogFactory::setDialogPoolSize(int size)
+{
+    IncidenceDialogPool::instance()->setSize(size);
+}
+
+void IncidenceDialogFactory::releaseDialog(IncidenceDialog *dialog)
+{
+    IncidenceDialogPool::instance()->release(dialog);
+}
+
 IncidenceDialog *IncidenceDialogFactory::createTodoEditor(const QString &summary,
                                                           const QString &description,
                                                           const QStringList &attachments,
@@ -64,6 +76,9 @@ IncidenceDialog *IncidenceDialogFactory::createTodoEditor(const QString &summary
     todo->setSummary(summary);
     todo->setDescription(description);
 
+    // Get the free/busy data of the attendees while the dialog is set up
+    FreeBusyCache::instance()->prefetch(todo->attendees(), parent);
+
     Akonadi::Item item;
     item.setPayload(todo);
 
@@ -102,6 +117,9 @@ IncidenceDialog *IncidenceDialogFactory::createEventEditor(const QString &summar
     event->setSummary(summary);
     event->setDescription(description);
 
+    // Get the free/busy data of the attendees while the dialog is set up
+    FreeBusyCache::instance()->prefetch(event->attendees(), parent);
+
     Akonadi::Item item;
     item.setPayload(event);
 
@@ -43,6 +43,24 @@ INCIDENCEEDITOR_EXPORT IncidenceDialog *create(bool needsSaving,
                                                QWidget *parent = nullptr,
                                                Qt::WindowFlags flags = {});
 
+/**
+ * Keeps @p size dialogs constructed in the background for each IncidenceChanger
+ * passed to create(), so that opening an editor only has to load the item.
+ * The dialogs for a changer are built after the first create() call with it,
+ * the ones handed out and not released yet count against @p size.
+ * A size of 0, the default, disables this.
+ */
+INCIDENCEEDITOR_EXPORT void setDialogPoolSize(int size);
+
+/**
+ * Gives a dialog returned by create() back once it has been closed and is not
+ * needed anymore, instead of deleting it. The dialog is reset and reused by a
+ * later create() call if the pool has room for it, and deleted later otherwise.
+ * The connections made to its signals are dropped either way.
+ * Don't use this for dialogs which delete themselves on close.
+ */
+INCIDENCEEDITOR_EXPORT void releaseDialog(IncidenceDialog *dialog);
+
 INCIDENCEEDITOR_EXPORT IncidenceDialog *createTodoEditor(const QString &summary,
                                                          const QString &description,
                                                          const QStringList &attachments,
@@ -0,0 +1,171 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "incidencedialogpool.h"
+#include "incidencedialog.h"
+
+#include <Akonadi/Calendar/IncidenceChanger>
+
+#include <QCoreApplication>
+
+#include <algorithm>
+
+using namespace IncidenceEditorNG;
+
+// Wait a bit before building a dialog, so it doesn't slow down the one
+// which has just been opened.
+static const int FILL_DELAY = 500; // ms
+
+Q_GLOBAL_STATIC(IncidenceDialogPool, sPool)
+
+IncidenceDialogPool *IncidenceDialogPool::instance()
+{
+    return sPool;
+}
+
+IncidenceDialogPool::IncidenceDialogPool()
+{
+    mFillTimer.setSingleShot(true);
+    mFillTimer.setInterval(FILL_DELAY);
+    connect(&mFillTimer, &QTimer::timeout, this, &IncidenceDialogPool::fill);
+
+    // The dialogs are widgets, they can't outlive the application object
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &IncidenceDialogPool::clear);
+    }
+}
+
+IncidenceDialogPool::~IncidenceDialogPool()
+{
+    if (QCoreApplication::instance()) {
+        clear();
+    }
+}
+
+void IncidenceDialogPool::setSize(int size)
+{
+    mSize = qMax(size, 0);
+    if (mSize == 0) {
+        clear();
+        return;
+    }
+
+    for (auto it = mDialogs.begin(), end = mDialogs.end(); it != end; ++it) {
+        while (it->size() > mSize) {
+            delete it->takeLast().data();
+        }
+    }
+    if (!mDialogs.isEmpty()) {
+        mFillTimer.start();
+    }
+}
+
+int IncidenceDialogPool::size() const
+{
+    return mSize;
+}
+
+IncidenceDialog *IncidenceDialogPool::create(Akonadi::IncidenceChanger *changer, QWidget *parent, Qt::WindowFlags flags)
+{
+    if (mSize == 0) {
+        return new IncidenceDialog(changer, parent, flags);
+    }
+
+    if (!mDialogs.contains(changer) && changer) {
+        connect(changer, &QObject::destroyed, this, &IncidenceDialogPool::removeChanger);
+    }
+
+    QVector<QPointer<IncidenceDialog>> &dialogs = mDialogs[changer];
+    IncidenceDialog *dialog = nullptr;
+    while (!dialog && !dialogs.isEmpty()) {
+        dialog = dialogs.takeLast();
+    }
+
+    if (dialog) {
+        // Like the QDialog constructor, make it a dialog window unless told otherwise
+        dialog->setParent(parent, (flags & Qt::WindowType_Mask) ? flags : flags | Qt::Dialog);
+    } else {
+        dialog = new IncidenceDialog(changer, parent, flags);
+    }
+
+    mChangerOfDialog.insert(dialog, changer);
+    connect(dialog, &QObject::destroyed, this, [this](QObject *object) {
+        mChangerOfDialog.remove(object);
+    });
+
+    mFillTimer.start();
+    return dialog;
+}
+
+void IncidenceDialogPool::release(IncidenceDialog *dialog)
+{
+    Q_ASSERT(dialog);
+
+    const auto it = mChangerOfDialog.constFind(dialog);
+    if (it == mChangerOfDialog.constEnd()) {
+        dialog->deleteLater();
+        return;
+    }
+
+    Akonadi::IncidenceChanger *changer = it.value();
+    mChangerOfDialog.erase(it);
+    disconnect(dialog, &QObject::destroyed, this, nullptr);
+
+    // The dialogs still handed out count against the size, they come back
+    // here as well.
+    if (mSize == 0 || !mDialogs.contains(changer) || dialogCount(changer) >= mSize || dialog->isVisible()) {
+        dialog->deleteLater();
+        return;
+    }
+
+    // reset() also drops whoever the previous user connected to the dialog
+    dialog->setParent(nullptr, dialog->windowFlags());
+    dialog->reset();
+    mDialogs[changer].append(dialog);
+}
+
+int IncidenceDialogPool::dialogCount(Akonadi::IncidenceChanger *changer) const
+{
+    const QVector<QPointer<IncidenceDialog>> dialogs = mDialogs.value(changer);
+    const int pooled = dialogs.size() - dialogs.count(QPointer<IncidenceDialog>());
+    return pooled + std::count(mChangerOfDialog.cbegin(), mChangerOfDialog.cend(), changer);
+}
+
+void IncidenceDialogPool::fill()
+{
+    // Build a single dialog at a time, and come back for the next one
+    for (auto it = mDialogs.begin(), end = mDialogs.end(); it != end; ++it) {
+        QVector<QPointer<IncidenceDialog>> &dialogs = it.value();
+        dialogs.removeAll(QPointer<IncidenceDialog>());
+        if (dialogCount(it.key()) < mSize) {
+            auto dialog = new IncidenceDialog(it.key());
+            dialogs.append(dialog);
+            mFillTimer.start();
+            return;
+        }
+    }
+}
+
+void IncidenceDialogPool::clear()
+{
+    mFillTimer.stop();
+    for (const QVector<QPointer<IncidenceDialog>> &dialogs : qAsConst(mDialogs)) {
+        for (const QPointer<IncidenceDialog> &dialog : dialogs) {
+            delete dialog.data();
+        }
+    }
+    mDialogs.clear();
+}
+
+void IncidenceDialogPool::removeChanger(QObject *changer)
+{
+    // The kept dialogs would use the deleted changer. It is only used as a
+    // key here.
+    const QVector<QPointer<IncidenceDialog>> dialogs = mDialogs.take(static_cast<Akonadi::IncidenceChanger *>(changer));
+    for (const QPointer<IncidenceDialog> &dialog : dialogs) {
+        delete dialog.data();
+    }
+}
@@ -0,0 +1,83 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class QWidget;
+
+namespace Akonadi
+{
+class IncidenceChanger;
+}
+
+namespace IncidenceEditorNG
+{
+class IncidenceDialog;
+
+/**
+ * Keeps IncidenceDialogs constructed in the background, so that opening an
+ * editor only has to load the item into one.
+ *
+ * The pool is disabled until setSize() is called. Once a dialog is asked for
+ * with a given IncidenceChanger, the pool keeps up to size() dialogs for that
+ * changer, building one at a time while the application is idle. The
+ * dialogs handed out by create() count against that size until they are
+ * given back with release(), which resets them for reuse instead of deleting
+ * them if the pool has room.
+ */
+class IncidenceDialogPool : public QObject
+{
+    Q_OBJECT
+public:
+    static IncidenceDialogPool *instance();
+
+    IncidenceDialogPool();
+    ~IncidenceDialogPool() override;
+
+    /**
+     * Sets the number of dialogs kept for each changer. 0 disables the pool
+     * and deletes the dialogs it holds.
+     */
+    void setSize(int size);
+    Q_REQUIRED_RESULT int size() const;
+
+    /**
+     * Returns a dialog for @p changer, shown as a window of @p parent with
+     * @p flags. It is taken from the pool if there is one, and created
+     * otherwise.
+     */
+    IncidenceDialog *create(Akonadi::IncidenceChanger *changer, QWidget *parent, Qt::WindowFlags flags);
+
+    /**
+     * Gives back a dialog returned by create(), once it's closed and the
+     * caller is done with it. The dialog is reset and kept if the pool has
+     * room for it, and deleted later otherwise. Resetting it drops the
+     * connections made to its signals.
+     */
+    void release(IncidenceDialog *dialog);
+
+private:
+    /**
+     * Returns the number of dialogs kept or handed out for @p changer.
+     */
+    Q_REQUIRED_RESULT int dialogCount(Akonadi::IncidenceChanger *changer) const;
+    void fill();
+    void clear();
+    void removeChanger(QObject *changer);
+
+    QHash<Akonadi::IncidenceChanger *, QVector<QPointer<IncidenceDialog>>> mDialogs;
+    QHash<QObject *, Akonadi::IncidenceChanger *> mChangerOfDialog; //!< the dialogs handed out by create()
+    QTimer mFillTimer;
+    int mSize = 0;
+};
+}
+
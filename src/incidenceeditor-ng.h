@@ -11,6 +11,8 @@
 
 #include <AkonadiCore/Item>
 #include <KCalendarCore/Incidence>
+
+#include <functional>
 namespace IncidenceEditorNG
 {
 /**
@@ -84,6 +86,13 @@ public:
     */
     virtual void printDebugInfo() const;
 
+    /**
+     * Runs a dirty check scheduled by scheduleDirtyCheck() or fieldsChanged()
+     * right away instead of waiting for the event loop, e.g. before the dirty
+     * status is queried.
+     */
+    void flushDirtyStatus();
+
 Q_SIGNALS:
     /**
      * Signals whether the dirty status of this editor has changed. The new dirty
@@ -107,11 +116,44 @@ protected:
         return inc.dynamicCast<IncidenceT>();
     }
 
+    enum : uint { AllFields = ~0u };
+
+    /**
+     * Like checkDirtyStatus(), but the check runs once the event loop is
+     * reached again, so that the many signals emitted while editing only
+     * lead to one check.
+     */
+    void scheduleDirtyCheck();
+
+    /**
+     * Like scheduleDirtyCheck(), but only marks the parts of the editor in
+     * @p fields as changed. The meaning of the bits is up to the subclass,
+     * see setDirtyCheck().
+     */
+    void fieldsChanged(uint fields);
+
+    /**
+     * Sets the function finding out whether the editor is dirty. It gets the
+     * fields passed to fieldsChanged() since the last check, or AllFields, so
+     * that subclasses keeping the dirty status of each field can re-compare
+     * only the changed ones. By default isDirty() is used.
+     */
+    void setDirtyCheck(const std::function<bool(uint changedFields)> &check);
+
+    /**
+     * Makes flushDirtyStatus() also run the dirty check scheduled by
+     * @p editor, for editors forwarding its dirtyStatusChanged signal.
+     */
+    void setDirtyStatusSource(IncidenceEditor *editor);
+
 protected:
     KCalendarCore::Incidence::Ptr mLoadedIncidence;
     mutable QString mLastErrorString;
     bool mWasDirty = false;
     bool mLoadingIncidence = false;
+
+private:
+    void runDirtyCheck(uint changedFields);
 };
 } // IncidenceEditorNG
 
@@ -9,8 +9,26 @@
 
 #include "incidenceeditor_debug.h"
 
+#include <QHash>
+#include <QPointer>
+
 using namespace IncidenceEditorNG;
 
+namespace
+{
+struct DirtyCheckState {
+    std::function<bool(uint)> check;
+    QPointer<IncidenceEditor> source;
+    uint changedFields = 0;
+    bool pending = false;
+};
+}
+
+// IncidenceEditor is installed, so the state of the scheduled dirty checks is
+// kept here to leave its size and vtable alone.
+using DirtyCheckStates = QHash<const IncidenceEditor *, DirtyCheckState>;
+Q_GLOBAL_STATIC(DirtyCheckStates, sDirtyCheckStates)
+
 IncidenceEditor::IncidenceEditor(QObject *parent)
     : QObject(parent)
 {
@@ -18,9 +36,73 @@ IncidenceEditor::IncidenceEditor(QObject *parent)
 
 IncidenceEditor::~IncidenceEditor()
 {
+    if (!sDirtyCheckStates.isDestroyed()) {
+        sDirtyCheckStates->remove(this);
+    }
 }
 
 void IncidenceEditor::checkDirtyStatus()
+{
+    // A full check, which makes the one still scheduled pointless
+    const auto it = sDirtyCheckStates->find(this);
+    if (it != sDirtyCheckStates->end()) {
+        it->changedFields = 0;
+        it->pending = false;
+    }
+    runDirtyCheck(AllFields);
+}
+
+void IncidenceEditor::scheduleDirtyCheck()
+{
+    fieldsChanged(AllFields);
+}
+
+void IncidenceEditor::fieldsChanged(uint fields)
+{
+    if (mLoadingIncidence) {
+        // Still loading the incidence, ignore changes to widgets.
+        return;
+    }
+
+    DirtyCheckState &state = (*sDirtyCheckStates)[this];
+    state.changedFields |= fields;
+    if (!state.pending) {
+        state.pending = true;
+        QMetaObject::invokeMethod(this, &IncidenceEditor::flushDirtyStatus, Qt::QueuedConnection);
+    }
+}
+
+void IncidenceEditor::setDirtyCheck(const std::function<bool(uint)> &check)
+{
+    (*sDirtyCheckStates)[this].check = check;
+}
+
+void IncidenceEditor::setDirtyStatusSource(IncidenceEditor *editor)
+{
+    (*sDirtyCheckStates)[this].source = editor;
+}
+
+void IncidenceEditor::flushDirtyStatus()
+{
+    auto it = sDirtyCheckStates->find(this);
+    if (it == sDirtyCheckStates->end()) {
+        return;
+    }
+    if (it->source) {
+        it->source->flushDirtyStatus();
+        // The check of the source may have changed the hash
+        it = sDirtyCheckStates->find(this);
+    }
+    if (it == sDirtyCheckStates->end() || !it->pending) {
+        return;
+    }
+    it->pending = false;
+    const uint changedFields = it->changedFields;
+    it->changedFields = 0;
+    runDirtyCheck(changedFields);
+}
+
+void IncidenceEditor::runDirtyCheck(uint changedFields)
 {
     if (!mLoadedIncidence) {
         qCDebug(INCIDENCEEDITOR_LOG) << "checkDirtyStatus called on an invalid incidence";
@@ -31,7 +113,8 @@ void IncidenceEditor::checkDirtyStatus()
         // Still loading the incidence, ignore changes to widgets.
         return;
     }
-    const bool dirty = isDirty();
+    const std::function<bool(uint)> check = sDirtyCheckStates->value(this).check;
+    const bool dirty = check ? check(changedFields) : isDirty();
     if (mWasDirty != dirty) {
         mWasDirty = dirty;
         Q_EMIT dirtyStatusChanged(dirty);
@@ -18,8 +18,15 @@ IncidenceWhatWhere::IncidenceWhatWhere(Ui::EventOrTodoDesktop *ui)
     , mUi(ui)
 {
     setObjectName(QStringLiteral("IncidenceWhatWhere"));
-    connect(mUi->mSummaryEdit, &QLineEdit::textChanged, this, &IncidenceWhatWhere::checkDirtyStatus);
-    connect(mUi->mLocationEdit, &QLineEdit::textChanged, this, &IncidenceWhatWhere::checkDirtyStatus);
+    setDirtyCheck([this](uint changedFields) {
+        return isDirtyAfterChanges(changedFields);
+    });
+    connect(mUi->mSummaryEdit, &QLineEdit::textChanged, this, [this]() {
+        fieldsChanged(SummaryField);
+    });
+    connect(mUi->mLocationEdit, &QLineEdit::textChanged, this, [this]() {
+        fieldsChanged(LocationField);
+    });
 }
 
 void IncidenceWhatWhere::load(const KCalendarCore::Incidence::Ptr &incidence)
@@ -38,6 +45,8 @@ void IncidenceWhatWhere::load(const KCalendarCore::Incidence::Ptr &incidence)
     mUi->mLocationLabel->setVisible(type() != KCalendarCore::Incidence::TypeJournal);
 
     mWasDirty = false;
+    mSummaryDirty = false;
+    mLocationDirty = false;
 }
 
 void IncidenceWhatWhere::save(const KCalendarCore::Incidence::Ptr &incidence)
@@ -56,6 +65,20 @@ bool IncidenceWhatWhere::isDirty() const
     }
 }
 
+bool IncidenceWhatWhere::isDirtyAfterChanges(uint changedFields)
+{
+    if (!mLoadedIncidence) {
+        return isDirty();
+    }
+    if (changedFields & SummaryField) {
+        mSummaryDirty = mUi->mSummaryEdit->text() != mLoadedIncidence->summary();
+    }
+    if (changedFields & LocationField) {
+        mLocationDirty = mUi->mLocationEdit->text() != mLoadedIncidence->location();
+    }
+    return mSummaryDirty || mLocationDirty;
+}
+
 void IncidenceWhatWhere::focusInvalidField()
 {
     if (mUi->mSummaryEdit->text().isEmpty()) {
@@ -38,7 +38,13 @@ public:
     virtual void validate();
 
 private:
+    enum Field : uint { SummaryField = 0x1, LocationField = 0x2 };
+
+    Q_REQUIRED_RESULT bool isDirtyAfterChanges(uint changedFields);
+
     Ui::EventOrTodoDesktop *const mUi;
+    bool mSummaryDirty = false;
+    bool mLocationDirty = false;
 };
 } // IncidenceEditorNG
 
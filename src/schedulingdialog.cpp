@@ -60,6 +60,10 @@ SchedulingDialog::SchedulingDialog(const QDate &startDate, const QTime &startTim
     connect(mWeekdayCombo, &IncidenceEditorNG::KWeekdayCheckCombo::checkedItemsChanged, this, &SchedulingDialog::slotMandatoryRolesChanged);
 
     connect(mResolver, &ConflictResolver::freeSlotsAvailable, mPeriodModel, &CalendarSupport::FreePeriodModel::slotNewFreePeriods);
+    connect(mResolver, &ConflictResolver::busyCountsChanged, this, [this]() {
+        mVisualWidget->setBusyCounts(mResolver->busyCountsGrid(), mResolver->busyCounts());
+    });
+    mVisualWidget->setBusyCounts(mResolver->busyCountsGrid(), mResolver->busyCounts());
     connect(mMoveBeginTimeEdit, &KTimeComboBox::timeEdited, this, &SchedulingDialog::slotSetEndTimeLabel);
 
     mTableView->setModel(mPeriodModel);
@@ -0,0 +1,204 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "slotgrid.h"
+
+#include <QTimeZone>
+
+#include <algorithm>
+
+using namespace IncidenceEditorNG;
+
+static const qint64 MSECS_PER_DAY = 24 * 60 * 60 * 1000;
+static const qint64 MSECS_PER_HOUR = 60 * 60 * 1000;
+static const qint64 JULIAN_DAY_OF_EPOCH = 2440588; // 1970-01-01
+
+static qint64 floorDiv(qint64 numerator, qint64 denominator)
+{
+    const qint64 quotient = numerator / denominator;
+    return (numerator % denominator < 0) ? quotient - 1 : quotient;
+}
+
+static qint64 ceilDiv(qint64 numerator, qint64 denominator)
+{
+    const qint64 quotient = numerator / denominator;
+    return (numerator % denominator > 0) ? quotient + 1 : quotient;
+}
+
+SlotGrid::SlotGrid(const QDateTime &begin, const QDateTime &end, int resolution)
+    : mBegin(begin)
+    , mBeginMSecs(begin.toMSecsSinceEpoch())
+    , mEndMSecs(end.toMSecsSinceEpoch())
+    , mResolutionMSecs(qint64(resolution) * 1000)
+    , mResolution(resolution)
+{
+    if (resolution <= 0 || mEndMSecs <= mBeginMSecs) {
+        return;
+    }
+    // the same as begin.secsTo(end) / resolution
+    mRange = (mEndMSecs - mBeginMSecs) / 1000 / resolution;
+
+    mOffsets.append({mBeginMSecs, begin.offsetFromUtc()});
+    if (begin.timeSpec() != Qt::LocalTime && begin.timeSpec() != Qt::TimeZone) {
+        return; // a fixed offset
+    }
+    const QTimeZone timeZone = begin.timeZone();
+    if (timeZone.hasTransitions()) {
+        const QTimeZone::OffsetDataList transitions = timeZone.transitions(begin, end);
+        for (const QTimeZone::OffsetData &transition : transitions) {
+            const qint64 from = transition.atUtc.toMSecsSinceEpoch();
+            if (from > mBeginMSecs && transition.offsetFromUtc != mOffsets.constLast().seconds) {
+                mOffsets.append({from, transition.offsetFromUtc});
+            }
+        }
+    } else {
+        // Without transition data, look for changes hour by hour
+        for (qint64 from = mBeginMSecs + MSECS_PER_HOUR; from < mEndMSecs; from += MSECS_PER_HOUR) {
+            const int offset = timeZone.offsetFromUtc(QDateTime::fromMSecsSinceEpoch(from, Qt::UTC));
+            if (offset != mOffsets.constLast().seconds) {
+                mOffsets.append({from, offset});
+            }
+        }
+    }
+}
+
+QDateTime SlotGrid::begin() const
+{
+    return mBegin;
+}
+
+QDateTime SlotGrid::end() const
+{
+    return mBegin.addMSecs(mEndMSecs - mBeginMSecs);
+}
+
+int SlotGrid::resolution() const
+{
+    return mResolution;
+}
+
+int SlotGrid::range() const
+{
+    return mRange;
+}
+
+QDateTime SlotGrid::slotStart(int slot) const
+{
+    return mBegin.addSecs(qint64(slot) * mResolution);
+}
+
+bool SlotGrid::slotSpan(const KCalendarCore::Period &period, int *first, int *count) const
+{
+    // Works on milliseconds, but rounds like QDateTime::secsTo() does
+    const qint64 start = period.start().toMSecsSinceEpoch();
+    const qint64 end = period.end().toMSecsSinceEpoch();
+    if (end < mBeginMSecs || start > mEndMSecs) {
+        return false;
+    }
+
+    if (end <= mEndMSecs && start >= mBeginMSecs) {
+        // case1: the period is completely in our timeframe
+        *first = (start - mBeginMSecs) / mResolutionMSecs;
+        *count = (end - start) / 1000 / mResolution;
+    } else if (start <= mBeginMSecs && end <= mEndMSecs) {
+        // case2: the period begins before our timeframe begins
+        *first = 0;
+        *count = (end - mBeginMSecs) / mResolutionMSecs;
+    } else if (end >= mEndMSecs && start >= mBeginMSecs) {
+        // case3: the period ends after our timeframe ends
+        *first = (start - mBeginMSecs) / mResolutionMSecs;
+        *count = mRange - *first;
+    } else {
+        // case4: case2+case3: our timeframe is inside the period
+        *first = 0;
+        *count = mRange;
+    }
+    Q_ASSERT(*first + *count <= mRange); // sanity check
+    return true;
+}
+
+int SlotGrid::utcOffset(qint64 msecs) const
+{
+    if (mOffsets.isEmpty()) {
+        return mBegin.offsetFromUtc();
+    }
+    auto it = std::upper_bound(mOffsets.cbegin(), mOffsets.cend(), msecs, [](qint64 value, const Offset &offset) {
+        return value < offset.from;
+    });
+    return it == mOffsets.cbegin() ? it->seconds : (it - 1)->seconds;
+}
+
+QVector<SlotGrid::Day> SlotGrid::days() const
+{
+    QVector<Day> days;
+    if (mRange <= 0) {
+        return days;
+    }
+
+    // The local day of a time t is floor((t + offset(t)) / day). It changes at
+    // the local midnights within each span of constant offset, and possibly
+    // where the offset changes.
+    const qint64 lastSlotStart = mBeginMSecs + (mRange - 1) * mResolutionMSecs;
+    qint64 currentDay = floorDiv(mBeginMSecs + mOffsets.constFirst().seconds * 1000LL, MSECS_PER_DAY);
+    qint64 currentStart = mBeginMSecs;
+    const auto addDay = [&](qint64 nextStart, qint64 nextDay) {
+        if (nextDay == currentDay) {
+            return;
+        }
+        const int first = ceilDiv(currentStart - mBeginMSecs, mResolutionMSecs);
+        const int last = ceilDiv(nextStart - mBeginMSecs, mResolutionMSecs);
+        if (first < last) {
+            days.append({QDate::fromJulianDay(currentDay + JULIAN_DAY_OF_EPOCH), first, last});
+        }
+        currentDay = nextDay;
+        currentStart = nextStart;
+    };
+
+    for (int i = 0; i < mOffsets.size(); ++i) {
+        const qint64 offset = mOffsets.at(i).seconds * 1000LL;
+        const qint64 spanStart = mOffsets.at(i).from;
+        if (spanStart > lastSlotStart) {
+            break;
+        }
+        const qint64 spanEnd = i + 1 < mOffsets.size() ? qMin(mOffsets.at(i + 1).from, lastSlotStart + 1) : lastSlotStart + 1;
+        if (i > 0) {
+            addDay(spanStart, floorDiv(spanStart + offset, MSECS_PER_DAY));
+        }
+        for (qint64 midnight = (floorDiv(spanStart + offset, MSECS_PER_DAY) + 1) * MSECS_PER_DAY - offset; midnight < spanEnd; midnight += MSECS_PER_DAY) {
+            addDay(midnight, floorDiv(midnight + offset, MSECS_PER_DAY));
+        }
+    }
+    // the day of the last slot
+    const int first = ceilDiv(currentStart - mBeginMSecs, mResolutionMSecs);
+    if (first < mRange) {
+        days.append({QDate::fromJulianDay(currentDay + JULIAN_DAY_OF_EPOCH), first, mRange});
+    }
+    return days;
+}
+
+qint64 SlotGrid::toMSecs(const QDate &date, const QTime &time) const
+{
+    QDateTime dateTime = mBegin;
+    dateTime.setDate(date);
+    dateTime.setTime(time);
+    return dateTime.toMSecsSinceEpoch();
+}
+
+qint64 SlotGrid::firstSlotStartingAt(const QDate &date, const QTime &time) const
+{
+    return ceilDiv(toMSecs(date, time) - mBeginMSecs, mResolutionMSecs);
+}
+
+qint64 SlotGrid::lastSlotEndingAt(const QDate &date, const QTime &time) const
+{
+    return floorDiv(toMSecs(date, time) - mBeginMSecs, mResolutionMSecs);
+}
+
+bool SlotGrid::operator==(const SlotGrid &other) const
+{
+    return mResolution == other.mResolution && mBeginMSecs == other.mBeginMSecs && mEndMSecs == other.mEndMSecs && mBegin.timeSpec() == other.mBegin.timeSpec()
+        && mBegin.offsetFromUtc() == other.mBegin.offsetFromUtc() && mBegin.timeZone() == other.mBegin.timeZone();
+}
@@ -0,0 +1,111 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM developers
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "incidenceeditor_private_export.h"
+
+#include <KCalendarCore/Period>
+
+#include <QDateTime>
+#include <QVector>
+
+namespace IncidenceEditorNG
+{
+/**
+ * The division of a timeframe into time slots of a fixed length.
+ *
+ * The grid is kept in milliseconds since the epoch, so mapping times onto
+ * slots is integer arithmetic only, whatever time zones the times are in.
+ * For the wall clock questions, which day a slot lies in, the grid keeps
+ * a table of the UTC offsets of the time zone of the timeframe, with an
+ * entry for every transition within the timeframe.
+ */
+class INCIDENCEEDITOR_TESTS_EXPORT SlotGrid
+{
+public:
+    /**
+     * The time slots starting on one day, in the time zone of the timeframe.
+     */
+    struct Day {
+        QDate date;
+        int first = 0; //!< the first slot starting on date
+        int last = 0; //!< one past the last slot starting on date
+    };
+
+    SlotGrid() = default;
+
+    /**
+     * Creates a grid for the timeframe (@p begin, @p end) divided into slots
+     * of @p resolution seconds. A partial slot at the end is dropped.
+     */
+    SlotGrid(const QDateTime &begin, const QDateTime &end, int resolution);
+
+    Q_REQUIRED_RESULT QDateTime begin() const;
+    Q_REQUIRED_RESULT QDateTime end() const;
+    Q_REQUIRED_RESULT int resolution() const;
+
+    /**
+     * Returns the number of slots.
+     */
+    Q_REQUIRED_RESULT int range() const;
+
+    /**
+     * Returns the start of @p slot, in the time zone of the timeframe.
+     */
+    Q_REQUIRED_RESULT QDateTime slotStart(int slot) const;
+
+    /**
+     * Maps @p period onto the grid. Returns false if the period does not
+     * touch the timeframe, otherwise stores the first busy slot in @p first
+     * and the number of busy slots in @p count.
+     */
+    bool slotSpan(const KCalendarCore::Period &period, int *first, int *count) const;
+
+    /**
+     * Returns the UTC offset in seconds of the time zone of the timeframe at
+     * @p msecs milliseconds since the epoch.
+     */
+    Q_REQUIRED_RESULT int utcOffset(qint64 msecs) const;
+
+    /**
+     * Returns the days the slots start on, in order. A day occurs twice if
+     * the clock is turned back across midnight.
+     */
+    Q_REQUIRED_RESULT QVector<Day> days() const;
+
+    /**
+     * Returns the first slot starting at or after @p time on @p date, in
+     * the time zone of the timeframe. May be negative or past range().
+     */
+    Q_REQUIRED_RESULT qint64 firstSlotStartingAt(const QDate &date, const QTime &time) const;
+
+    /**
+     * Returns one past the last slot ending at or before @p time on @p date,
+     * in the time zone of the timeframe. May be negative or past range().
+     */
+    Q_REQUIRED_RESULT qint64 lastSlotEndingAt(const QDate &date, const QTime &time) const;
+
+    Q_REQUIRED_RESULT bool operator==(const SlotGrid &other) const;
+
+private:
+    struct Offset {
+        qint64 from; //!< msecs since epoch the offset applies from
+        int seconds; //!< the UTC offset
+    };
+
+    qint64 toMSecs(const QDate &date, const QTime &time) const;
+
+    QDateTime mBegin;
+    qint64 mBeginMSecs = 0;
+    qint64 mEndMSecs = 0;
+    qint64 mResolutionMSecs = 0;
+    int mResolution = 0;
+    int mRange = 0;
+    QVector<Offset> mOffsets; //!< sorted, the first one applies from the beginning
+};
+}
+
@@ -7,6 +7,7 @@
 
 #include "visualfreebusywidget.h"
 #include "freebusyganttproxymodel.h"
+#include "freebusyheatmap.h"
 #include <CalendarSupport/FreeBusyItemModel>
 
 #include <KGantt/KGanttAbstractRowController>
@@ -104,6 +105,11 @@ public:
         mRowHeight = height;
     }
 
+    int rowHeight() const
+    {
+        return mRowHeight;
+    }
+
 private:
     int mRowHeight;
 };
@@ -226,8 +232,28 @@ VisualFreeBusyWidget::VisualFreeBusyWidget(CalendarSupport::FreeBusyItemModel *m
     mGanttGraphicsView->setModel(mModel);
     mGanttGraphicsView->viewport()->setFixedWidth(800 * 30);
 
-    splitter->addWidget(mLeftView);
-    splitter->addWidget(mGanttGraphicsView);
+    // The busy attendee count of all attendees, below their rows
+    mHeatMap = new FreeBusyHeatMap(this);
+    mHeatMap->setFixedHeight(2 * fontMetrics().height());
+    mHeatMap->setToolTip(i18nc("@info:tooltip", "Shows how many attendees are busy at each time"));
+    auto heatMapLabel = new QLabel(i18nc("@label", "Busy attendees"), this);
+    heatMapLabel->setFixedHeight(mHeatMap->height());
+
+    auto leftWidget = new QWidget(this);
+    auto leftLayout = new QVBoxLayout(leftWidget);
+    leftLayout->setContentsMargins(0, 0, 0, 0);
+    leftLayout->setSpacing(0);
+    leftLayout->addWidget(mLeftView);
+    leftLayout->addWidget(heatMapLabel);
+    auto rightWidget = new QWidget(this);
+    auto rightLayout = new QVBoxLayout(rightWidget);
+    rightLayout->setContentsMargins(0, 0, 0, 0);
+    rightLayout->setSpacing(0);
+    rightLayout->addWidget(mGanttGraphicsView);
+    rightLayout->addWidget(mHeatMap);
+
+    splitter->addWidget(leftWidget);
+    splitter->addWidget(rightWidget);
 
     topLayout->addWidget(splitter);
     topLayout->setStretchFactor(splitter, 100);
@@ -238,6 +264,17 @@ VisualFreeBusyWidget::VisualFreeBusyWidget(CalendarSupport::FreeBusyItemModel *m
     mGanttGrid->setStartDateTime(horizonStart);
 
     connect(mLeftView, &QTreeView::customContextMenuRequested, this, &VisualFreeBusyWidget::showAttendeeStatusMenu);
+
+    // Only the periods around the visible part of the chart get Gantt items,
+    // and the heat map follows the chart
+    connect(mGanttGraphicsView->horizontalScrollBar(), &QScrollBar::valueChanged, this, &VisualFreeBusyWidget::chartViewportChanged);
+    connect(mGanttGraphicsView->verticalScrollBar(), &QScrollBar::valueChanged, this, &VisualFreeBusyWidget::chartViewportChanged);
+    connect(mGanttGrid, &KGantt::AbstractGrid::gridChanged, this, &VisualFreeBusyWidget::chartViewportChanged);
+}
+
+void VisualFreeBusyWidget::setBusyCounts(const SlotGrid &grid, const QVector<int> &counts)
+{
+    mHeatMap->setBusyCounts(grid, counts);
 }
 
 VisualFreeBusyWidget::~VisualFreeBusyWidget()
@@ -301,4 +338,63 @@ void VisualFreeBusyWidget::slotZoomToTime()
 
 void VisualFreeBusyWidget::splitterMoved()
 {
+    chartViewportChanged();
+}
+
+void VisualFreeBusyWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    chartViewportChanged();
+}
+
+void VisualFreeBusyWidget::chartViewportChanged()
+{
+    updateLevelOfDetail();
+    updateVisibleWindow();
+    updateHeatMapScale();
+}
+
+void VisualFreeBusyWidget::updateLevelOfDetail()
+{
+    // Periods less than a pixel apart are drawn as one item
+    const QDateTime origin = mGanttGrid->startDateTime();
+    const qreal pixelsPerDay = mGanttGrid->mapFromDateTime(origin.addDays(1)) - mGanttGrid->mapFromDateTime(origin);
+    mModel->setMergeDistance(pixelsPerDay > 0 ? qRound(24 * 60 * 60 / pixelsPerDay) : 0);
+}
+
+void VisualFreeBusyWidget::updateHeatMapScale()
+{
+    const QDateTime origin = mGanttGrid->startDateTime();
+    const qreal originX = mGanttGrid->mapFromDateTime(origin);
+    mHeatMap->setTimeScale(origin, (mGanttGrid->mapFromDateTime(origin.addDays(1)) - originX) / (24 * 60 * 60));
+
+    // the chart position at the left edge of the heat map
+    const qreal viewportX = mGanttGraphicsView->viewport()->mapTo(this, QPoint()).x() - mHeatMap->mapTo(this, QPoint()).x();
+    mHeatMap->setScrollOffset(mGanttGraphicsView->mapToScene(QPoint()).x() - originX - viewportX);
+}
+
+void VisualFreeBusyWidget::updateVisibleWindow()
+{
+    const QRectF visible = mGanttGraphicsView->mapToScene(QRect(QPoint(0, 0), mGanttGraphicsView->size())).boundingRect();
+    const QDateTime start = mGanttGrid->mapToDateTime(visible.left());
+    const QDateTime end = mGanttGrid->mapToDateTime(visible.right());
+    const int rowHeight = qMax(mRowController->rowHeight(), 1);
+    const int firstRow = qMax(int(visible.top()), 0) / rowHeight;
+    const int lastRow = qMax(int(visible.bottom()), 0) / rowHeight;
+    if (!start.isValid() || !end.isValid()) {
+        return;
+    }
+    if (mLoadedStart.isValid() && start >= mLoadedStart && end <= mLoadedEnd && firstRow >= mLoadedFirstRow && lastRow <= mLoadedLastRow) {
+        return;
+    }
+
+    // Load a screen ahead in every direction, so that scrolling a little
+    // does not have to filter the periods again.
+    const qint64 secs = start.secsTo(end);
+    const int rows = lastRow - firstRow + 1;
+    mLoadedStart = start.addSecs(-secs);
+    mLoadedEnd = end.addSecs(secs);
+    mLoadedFirstRow = firstRow - rows;
+    mLoadedLastRow = lastRow + rows;
+    mModel->setVisibleWindow(mLoadedStart, mLoadedEnd, mLoadedFirstRow, mLoadedLastRow);
 }
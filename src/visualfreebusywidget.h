@@ -8,6 +8,7 @@
 #pragma once
 
 #include <QDateTime>
+#include <QVector>
 #include <QWidget>
 
 namespace KGantt
@@ -22,12 +23,15 @@ class FreeBusyItemModel;
 }
 
 class QComboBox;
+class QResizeEvent;
 class QTreeView;
 
 namespace IncidenceEditorNG
 {
 class FreeBusyGanttProxyModel;
+class FreeBusyHeatMap;
 class RowController;
+class SlotGrid;
 
 class VisualFreeBusyWidget : public QWidget
 {
@@ -36,6 +40,13 @@ public:
     explicit VisualFreeBusyWidget(CalendarSupport::FreeBusyItemModel *model, int spacing = 8, QWidget *parent = nullptr);
     ~VisualFreeBusyWidget() override;
 
+    /**
+     * Sets the number of busy attendees in each slot of @p grid,
+     * shown as a heat map below the chart.
+     * @see ConflictResolver::busyCounts
+     */
+    void setBusyCounts(const SlotGrid &grid, const QVector<int> &counts);
+
 public Q_SLOTS:
     void slotUpdateIncidenceStartEnd(const QDateTime &, const QDateTime &);
 
@@ -43,6 +54,9 @@ Q_SIGNALS:
     void dateTimesChanged(const QDateTime &, const QDateTime &);
     void manualReload();
 
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
 protected Q_SLOTS:
     void slotScaleChanged(int);
     void slotCenterOnStart();
@@ -53,6 +67,10 @@ protected Q_SLOTS:
 
 private:
     void splitterMoved();
+    void chartViewportChanged();
+    void updateLevelOfDetail();
+    void updateVisibleWindow();
+    void updateHeatMapScale();
     KGantt::GraphicsView *mGanttGraphicsView = nullptr;
     QTreeView *mLeftView = nullptr;
     RowController *mRowController = nullptr;
@@ -60,7 +78,13 @@ private:
 
     QComboBox *mScaleCombo = nullptr;
     FreeBusyGanttProxyModel *mModel = nullptr;
+    FreeBusyHeatMap *mHeatMap = nullptr;
 
     QDateTime mDtStart, mDtEnd;
+
+    // the part of the chart the Gantt model currently exposes periods for
+    QDateTime mLoadedStart, mLoadedEnd;
+    int mLoadedFirstRow = 0;
+    int mLoadedLastRow = 0;
 };
 }